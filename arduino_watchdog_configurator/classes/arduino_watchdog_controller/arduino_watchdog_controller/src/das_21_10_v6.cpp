@@ -25,6 +25,9 @@ const uint8_t kTimeoutErrorByte = 0x10;
 
 enum class WdAck : uint8_t { Ack = kAckByte, Nack = kNackByte };
 
+// CRC16 of an intact input message, CRC bytes included
+const uint16_t kCrc16Residue = 0x0000;
+
 const unsigned long kThresholdMs = 30;    // Timeout threshold in ms
 unsigned long       lastReceivedTime = 0; // Timestamp of last received byte
 
@@ -51,7 +54,7 @@ enum class WdStatus : uint8_t {
 struct WdInputMsg {
     uint8_t  mStart_bytes[2]; // Start bytes (e.g., 'W' and 'C')
     uint8_t  mCmd;            // Command byte
-    uint16_t mCrc16;          // CRC16 checksum
+    uint8_t  mCrc16[2];       // CRC16 checksum as received, MSB first
 };
 
 // Response message format to acknowledge or reject commands
@@ -112,12 +115,9 @@ WdStatus getWatchdogConfiguration() {
 void processInputMsg() {
     WdResponse response;
 
-    // Calculate CRC16 for the input message (excluding the CRC bytes)
-    uint16_t calculatedCrc16 = calcCRC16((uint8_t *) &inputMsg.mStart_bytes,
-                                         sizeof(inputMsg.mStart_bytes) + sizeof(inputMsg.mCmd));
-
-    // Validate CRC
-    if (inputMsg.mCrc16 == calculatedCrc16) {
+    // Validate CRC, the CRC16 over the whole message including the
+    // received CRC is the residue when the message is intact
+    if (calcCRC16((uint8_t *) &inputMsg, sizeof(inputMsg)) == kCrc16Residue) {
         // Process the command
         switch (static_cast<WdCommand>(inputMsg.mCmd)) {
             case WdCommand::Disable:
@@ -209,13 +209,13 @@ void loop() {
                 break;
 
             case InputProcessState::WaitForCrc1:
-                inputMsg.mCrc16 = (receivedByte << 8); // Store MSB of CRC
+                inputMsg.mCrc16[0] = receivedByte; // Store MSB of CRC
                 currentState = InputProcessState::WaitForCrc2;
                 break;
 
             case InputProcessState::WaitForCrc2:
                 // Store LSB of CRC
-                inputMsg.mCrc16 |= receivedByte;
+                inputMsg.mCrc16[1] = receivedByte;
                 // Process the complete input message
                 processInputMsg();
                 resetStateMachine();
@@ -8,11 +8,31 @@
 
 #include "CRC.h"
 
+
+namespace
+{
+//  true when the run time parameters are those of the compile time Preset
+template <typename Preset, typename T>
+bool isPreset(T polynome, T initial, T xorOut, bool reverseIn, bool reverseOut)
+{
+  return polynome == Preset::getPolynome() && initial == Preset::getInitial() &&
+         xorOut == Preset::getXorOut() && reverseIn == Preset::getReverseIn() &&
+         reverseOut == Preset::getReverseOut();
+}
+}
+
+
 uint8_t calcCRC8(
   const uint8_t *array, crc_size_t length,
   uint8_t polynome, uint8_t initial, uint8_t xorOut,
   bool reverseIn, bool reverseOut, crc_size_t yieldPeriod)
 {
+  //  the default preset runs with CRC_DEFAULT_POLICY, see CrcPolicy.h
+  if (yieldPeriod == CRC_YIELD_DISABLED &&
+      isPreset<CRC_PRESET_POLICY(8, CRC8, CRC_DEFAULT_POLICY)>(polynome, initial, xorOut, reverseIn, reverseOut))
+  {
+    return CRC_PRESET_POLICY(8, CRC8, CRC_DEFAULT_POLICY)::compute(array, length);
+  }
   CRC8 crc(polynome, initial, xorOut, reverseIn, reverseOut);
   yieldPeriod == CRC_YIELD_DISABLED ?
     crc.add(array, length) :
@@ -25,6 +45,12 @@ uint16_t calcCRC12(
   uint16_t polynome, uint16_t initial, uint16_t xorOut,
   bool reverseIn, bool reverseOut, crc_size_t yieldPeriod)
 {
+  //  the default preset runs with CRC_DEFAULT_POLICY, see CrcPolicy.h
+  if (yieldPeriod == CRC_YIELD_DISABLED &&
+      isPreset<CRC_PRESET_POLICY(12, CRC12, CRC_DEFAULT_POLICY)>(polynome, initial, xorOut, reverseIn, reverseOut))
+  {
+    return CRC_PRESET_POLICY(12, CRC12, CRC_DEFAULT_POLICY)::compute(array, length);
+  }
   CRC12 crc(polynome, initial, xorOut, reverseIn, reverseOut);
   yieldPeriod == CRC_YIELD_DISABLED ?
     crc.add(array, length) :
@@ -37,6 +63,12 @@ uint16_t calcCRC16(
   uint16_t polynome, uint16_t initial, uint16_t xorOut,
   bool reverseIn, bool reverseOut, crc_size_t yieldPeriod)
 {
+  //  the default preset runs with CRC_DEFAULT_POLICY, see CrcPolicy.h
+  if (yieldPeriod == CRC_YIELD_DISABLED &&
+      isPreset<CRC_PRESET_POLICY(16, CRC16, CRC_DEFAULT_POLICY)>(polynome, initial, xorOut, reverseIn, reverseOut))
+  {
+    return CRC_PRESET_POLICY(16, CRC16, CRC_DEFAULT_POLICY)::compute(array, length);
+  }
   CRC16 crc(polynome, initial, xorOut, reverseIn, reverseOut);
   yieldPeriod == CRC_YIELD_DISABLED ?
     crc.add(array, length) :
@@ -49,6 +81,12 @@ uint32_t calcCRC32(
   uint32_t polynome, uint32_t initial, uint32_t xorOut,
   bool reverseIn, bool reverseOut, crc_size_t yieldPeriod)
 {
+  //  the default preset runs with CRC_DEFAULT_POLICY, see CrcPolicy.h
+  if (yieldPeriod == CRC_YIELD_DISABLED &&
+      isPreset<CRC_PRESET_POLICY(32, CRC32, CRC_DEFAULT_POLICY)>(polynome, initial, xorOut, reverseIn, reverseOut))
+  {
+    return CRC_PRESET_POLICY(32, CRC32, CRC_DEFAULT_POLICY)::compute(array, length);
+  }
   CRC32 crc(polynome, initial, xorOut, reverseIn, reverseOut);
   yieldPeriod == CRC_YIELD_DISABLED ?
     crc.add(array, length) :
@@ -61,6 +99,12 @@ uint64_t calcCRC64(
   uint64_t polynome, uint64_t initial, uint64_t xorOut,
   bool reverseIn, bool reverseOut, crc_size_t yieldPeriod)
 {
+  //  the default preset runs with CRC_DEFAULT_POLICY, see CrcPolicy.h
+  if (yieldPeriod == CRC_YIELD_DISABLED &&
+      isPreset<CRC_PRESET_POLICY(64, CRC64, CRC_DEFAULT_POLICY)>(polynome, initial, xorOut, reverseIn, reverseOut))
+  {
+    return CRC_PRESET_POLICY(64, CRC64, CRC_DEFAULT_POLICY)::compute(array, length);
+  }
   CRC64 crc(polynome, initial, xorOut, reverseIn, reverseOut);
   yieldPeriod == CRC_YIELD_DISABLED ?
     crc.add(array, length) :
@@ -13,6 +13,8 @@
 #include "CRC16.h"
 #include "CRC32.h"
 #include "CRC64.h"
+#include "CrcEngine.h"
+#include "CrcCombine.h"
 
 #define CRC_LIB_VERSION       (F("1.0.2"))
 
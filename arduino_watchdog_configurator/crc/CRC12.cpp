@@ -15,11 +15,12 @@ CRC12::CRC12(uint16_t polynome,
              bool reverseIn,
              bool reverseOut) :
   _polynome(polynome),
+  _reflectedPolynome(reverse12bits(polynome)),
   _initial(initial),
   _xorOut(xorOut),
   _reverseIn(reverseIn),
   _reverseOut(reverseOut),
-  _crc(initial),
+  _crc(reverseIn ? reverse12bits(initial) : initial),
   _count(0u)
 {}
 
@@ -30,6 +31,7 @@ void CRC12::reset(uint16_t polynome,
                   bool reverseOut)
 {
   _polynome = polynome;
+  _reflectedPolynome = reverse12bits(polynome);
   _initial = initial;
   _xorOut = xorOut;
   _reverseIn = reverseIn;
@@ -39,14 +41,15 @@ void CRC12::reset(uint16_t polynome,
 
 void CRC12::restart()
 {
-  _crc = _initial;
+  _crc = _reverseIn ? reverse12bits(_initial) : _initial;
   _count = 0u;
 }
 
 uint16_t CRC12::calc() const
 {
   uint16_t rv = _crc;
-  if (_reverseOut) rv = reverse12bits(rv);
+  //  a reflected register already is the reversed output
+  if (_reverseOut != _reverseIn) rv = reverse12bits(rv);
   rv ^= _xorOut;
   return rv & 0x0FFF;
 }
@@ -65,10 +68,7 @@ void CRC12::add(uint8_t value)
 void CRC12::add(const uint8_t *array, crc_size_t length)
 {
   _count += length;
-  while (length--)
-  {
-    _add(*array++);
-  }
+  _add(array, length);
 }
 
 void CRC12::add(const uint8_t *array, crc_size_t length, crc_size_t yieldPeriod)
@@ -86,22 +86,95 @@ void CRC12::add(const uint8_t *array, crc_size_t length, crc_size_t yieldPeriod)
   }
 }
 
+void CRC12::add(const CrcSegment *segments, crc_size_t count)
+{
+  while (count--)
+  {
+    add(segments->data, segments->length);
+    segments++;
+  }
+}
+
+void CRC12::addTimed(const uint8_t *array, crc_size_t length, uint32_t yieldMicros)
+{
+  _count += length;
+  uint32_t start = micros();
+  while (length > 0)
+  {
+    crc_size_t part = length < CRC_TIMED_CHUNK ? length : CRC_TIMED_CHUNK;
+    length -= part;
+    _add(array, part);
+    array += part;
+    if (micros() - start >= yieldMicros)
+    {
+      yield();
+      start = micros();
+    }
+  }
+}
+
+void CRC12::setPolynome(uint16_t polynome)
+{
+  _polynome = polynome;
+  _reflectedPolynome = reverse12bits(polynome);
+}
+
+void CRC12::setReverseIn(bool reverseIn)
+{
+  //  keep the running register in the domain of the new setting
+  if (reverseIn != _reverseIn) _crc = reverse12bits(_crc);
+  _reverseIn = reverseIn;
+}
+
 void CRC12::_add(uint8_t value)
 {
-  if (_reverseIn) value = reverse8bits(value);
-  _crc ^= ((uint16_t)value) << 4;
-  for (uint8_t i = 8; i; i--) 
+  _add(&value, 1);
+}
+
+//  one branch on _reverseIn per call, the register is kept in a local
+void CRC12::_add(const uint8_t *array, crc_size_t length)
+{
+  uint16_t crc = _crc;
+  if (_reverseIn)
   {
-    if (_crc & (1 << 11))
+    while (length--)
     {
-      _crc <<= 1;
-      _crc ^= _polynome;
+      //  LSB first, no reversal of the input byte needed
+      crc ^= *array++;
+      for (uint8_t i = 8; i; i--)
+      {
+        if (crc & 1)
+        {
+          crc >>= 1;
+          crc ^= _reflectedPolynome;
+        }
+        else
+        {
+          crc >>= 1;
+        }
+      }
     }
-    else
+  }
+  else
+  {
+    while (length--)
     {
-      _crc <<= 1;
+      crc ^= ((uint16_t)*array++) << 4;
+      for (uint8_t i = 8; i; i--)
+      {
+        if (crc & (1 << 11))
+        {
+          crc <<= 1;
+          crc ^= _polynome;
+        }
+        else
+        {
+          crc <<= 1;
+        }
+      }
     }
   }
+  _crc = crc;
 }
 
 uint16_t CRC12::getCRC() const
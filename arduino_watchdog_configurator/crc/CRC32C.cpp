@@ -0,0 +1,227 @@
+//
+//    FILE: CRC32C.cpp
+// PURPOSE: class for CRC32C (CRC32_CASTAGNOLI) using the SSE4.2 crc32 instruction
+//
+//  The crc32 instruction has a latency of three cycles and a throughput
+//  of one per cycle, so the buffer is split in three streams which are
+//  computed side by side and merged afterwards. Merging multiplies a
+//  stream CRC by x^(8 * length) mod P, done with four lookup tables per
+//  stream length ("zeros operator"), built on first use.
+
+
+#include "CRC32C.h"
+#include "CrcSlicing.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define CRC32C_SSE42 1
+#include <immintrin.h>
+#endif
+
+
+namespace
+{
+//  the reflected register, as kept by the crc32 instruction
+uint32_t softwareUpdate(uint32_t crc, const uint8_t *array, crc_size_t length)
+{
+  return crcSlicingUpdate<uint32_t, 32, CRC32_CASTAGNOLI_POLYNOME, true, 8>(crc, array, length);
+}
+
+#if defined(CRC32C_SSE42)
+
+//  stream lengths, long streams for bulk data, short ones for the rest
+const size_t LONG_STREAM  = 8192;
+const size_t SHORT_STREAM = 256;
+
+//  reflected CRC32C polynome, bit 31 is x^0
+const uint32_t REFLECTED_POLYNOME = 0x82F63B78;
+
+//  a * b mod P, both reflected
+uint32_t multiplyModP(uint32_t a, uint32_t b)
+{
+  uint32_t product = 0;
+  for (uint32_t m = 1u << 31; m != 0; m >>= 1)
+  {
+    if (a & m) product ^= b;
+    b = (b & 1) ? (b >> 1) ^ REFLECTED_POLYNOME : b >> 1;
+  }
+  return product;
+}
+
+//  x^(8 * bytes) mod P, reflected
+uint32_t xPowerBytes(size_t bytes)
+{
+  const uint32_t x0 = 1u << 31;
+  const uint32_t x8 = x0 >> 8;
+  uint32_t power = x0;
+  for (int bit = 8 * sizeof(size_t) - 1; bit >= 0; bit--)
+  {
+    power = multiplyModP(power, power);
+    if ((bytes >> bit) & 1) power = multiplyModP(power, x8);
+  }
+  return power;
+}
+
+//  tables that multiply a register by x^(8 * bytes) mod P, one per register byte
+struct ZerosOperator
+{
+  uint32_t table[4][256];
+
+  explicit ZerosOperator(size_t bytes)
+  {
+    uint32_t power = xPowerBytes(bytes);
+    for (int k = 0; k < 4; k++)
+    {
+      for (uint32_t b = 0; b < 256; b++)
+      {
+        table[k][b] = multiplyModP(b << (8 * k), power);
+      }
+    }
+  }
+
+  uint32_t shift(uint32_t crc) const
+  {
+    return table[0][crc & 0xFF] ^ table[1][(crc >> 8) & 0xFF]
+         ^ table[2][(crc >> 16) & 0xFF] ^ table[3][crc >> 24];
+  }
+};
+
+bool sse42Supported()
+{
+  static const bool supported = __builtin_cpu_supports("sse4.2");
+  return supported;
+}
+
+//  three streams of streamLength bytes, while there are enough bytes
+__attribute__((target("sse4.2")))
+uint64_t threeStreams(uint64_t crc, const uint8_t *&array, size_t &length,
+                      size_t streamLength, const ZerosOperator &zeros)
+{
+  while (length >= 3 * streamLength)
+  {
+    uint64_t crc1 = 0;
+    uint64_t crc2 = 0;
+    const uint8_t *end = array + streamLength;
+    do
+    {
+      uint64_t word0, word1, word2;
+      memcpy(&word0, array, 8);
+      memcpy(&word1, array + streamLength, 8);
+      memcpy(&word2, array + 2 * streamLength, 8);
+      crc  = _mm_crc32_u64(crc, word0);
+      crc1 = _mm_crc32_u64(crc1, word1);
+      crc2 = _mm_crc32_u64(crc2, word2);
+      array += 8;
+    }
+    while (array < end);
+    crc = zeros.shift((uint32_t)crc) ^ crc1;
+    crc = zeros.shift((uint32_t)crc) ^ crc2;
+    array += 2 * streamLength;
+    length -= 3 * streamLength;
+  }
+  return crc;
+}
+
+__attribute__((target("sse4.2")))
+uint32_t hardwareUpdate(uint32_t crc32, const uint8_t *array, size_t length)
+{
+  static const ZerosOperator longZeros(LONG_STREAM);
+  static const ZerosOperator shortZeros(SHORT_STREAM);
+
+  uint64_t crc = crc32;
+  while (length > 0 && ((uintptr_t)array & 7) != 0)
+  {
+    crc = _mm_crc32_u8((uint32_t)crc, *array++);
+    length--;
+  }
+
+  crc = threeStreams(crc, array, length, LONG_STREAM, longZeros);
+  crc = threeStreams(crc, array, length, SHORT_STREAM, shortZeros);
+
+  while (length >= 8)
+  {
+    uint64_t word;
+    memcpy(&word, array, 8);
+    crc = _mm_crc32_u64(crc, word);
+    array += 8;
+    length -= 8;
+  }
+  while (length--)
+  {
+    crc = _mm_crc32_u8((uint32_t)crc, *array++);
+  }
+  return (uint32_t)crc;
+}
+
+#endif
+}
+
+
+CRC32C::CRC32C() :
+  _crc(CRC32_CASTAGNOLI_INITIAL),
+  _count(0u)
+{}
+
+void CRC32C::restart()
+{
+  _crc = CRC32_CASTAGNOLI_INITIAL;
+  _count = 0u;
+}
+
+uint32_t CRC32C::calc() const
+{
+  //  reflected in and out, the register already is the reversed output
+  return _crc ^ CRC32_CASTAGNOLI_XOR_OUT;
+}
+
+crc_size_t CRC32C::count() const
+{
+  return _count;
+}
+
+void CRC32C::add(uint8_t value)
+{
+  add(&value, 1);
+}
+
+void CRC32C::add(const uint8_t *array, crc_size_t length)
+{
+  _count += length;
+#if defined(CRC32C_SSE42)
+  if (sse42Supported())
+  {
+    _crc = hardwareUpdate(_crc, array, length);
+    return;
+  }
+#endif
+  _crc = softwareUpdate(_crc, array, length);
+}
+
+void CRC32C::add(const uint8_t *array, crc_size_t length, crc_size_t yieldPeriod)
+{
+  if (yieldPeriod == CRC_YIELD_DISABLED)
+  {
+    add(array, length);
+    return;
+  }
+  while (length > 0)
+  {
+    crc_size_t part = length < yieldPeriod ? length : yieldPeriod;
+    add(array, part);
+    array += part;
+    length -= part;
+    if (part == yieldPeriod) yield();
+  }
+}
+
+bool CRC32C::hardware()
+{
+#if defined(CRC32C_SSE42)
+  return sse42Supported();
+#else
+  return false;
+#endif
+}
+
+
+//  -- END OF FILE --
+
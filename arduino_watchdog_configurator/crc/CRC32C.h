@@ -0,0 +1,34 @@
+#pragma once
+//
+//    FILE: CRC32C.h
+// PURPOSE: class for CRC32C (CRC32_CASTAGNOLI) using the SSE4.2 crc32 instruction
+//
+//  Host side class with the same API as CRC32 for the fixed
+//  CRC32_CASTAGNOLI preset. Uses the SSE4.2 crc32 instruction on three
+//  interleaved streams when the CPU has it, slicing-by-8 otherwise.
+
+
+#include "CrcParameters.h"
+#include "CrcDefines.h"
+
+
+class CRC32C
+{
+public:
+  CRC32C();
+
+  void restart();
+  uint32_t calc() const;
+  crc_size_t count() const;
+  void add(uint8_t value);
+  void add(const uint8_t *array, crc_size_t length);
+  void add(const uint8_t *array, crc_size_t length, crc_size_t yieldPeriod);
+
+  //  true when the SSE4.2 path is used
+  static bool hardware();
+
+private:
+  uint32_t _crc;
+  crc_size_t _count;
+};
+
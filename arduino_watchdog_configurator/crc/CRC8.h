@@ -8,6 +8,7 @@
 
 #include "CrcParameters.h"
 #include "CrcDefines.h"
+#include "CrcSegment.h"
 
 
 class CRC8
@@ -31,11 +32,15 @@ public:
   void add(uint8_t value);
   void add(const uint8_t *array, crc_size_t length);
   void add(const uint8_t *array, crc_size_t length, crc_size_t yieldPeriod);
+  //  count segments in message order, see CrcSegment.h
+  void add(const CrcSegment *segments, crc_size_t count);
+  //  yields when yieldMicros passed, checked every CRC_TIMED_CHUNK bytes
+  void addTimed(const uint8_t *array, crc_size_t length, uint32_t yieldMicros);
 
-  void setPolynome(uint8_t polynome) { _polynome = polynome; }
+  void setPolynome(uint8_t polynome);
   void setInitial(uint8_t initial) { _initial = initial; }
   void setXorOut(uint8_t xorOut) { _xorOut = xorOut; }
-  void setReverseIn(bool reverseIn) { _reverseIn = reverseIn; }
+  void setReverseIn(bool reverseIn);
   void setReverseOut(bool reverseOut) { _reverseOut = reverseOut; }
 
   uint8_t getPolynome() const { return _polynome; }
@@ -61,12 +66,16 @@ public:
 
 private:
   void _add(uint8_t value);
+  void _add(const uint8_t *array, crc_size_t length);
 
   uint8_t _polynome;
+  //  polynome for the reflected (right shifting) register
+  uint8_t _reflectedPolynome;
   uint8_t _initial;
   uint8_t _xorOut;
   bool _reverseIn;
   bool _reverseOut;
+  //  reflected register when _reverseIn is set
   uint8_t _crc;
   crc_size_t _count;
 };
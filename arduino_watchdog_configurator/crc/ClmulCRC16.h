@@ -0,0 +1,23 @@
+#pragma once
+//
+//    FILE: ClmulCRC16.h
+// PURPOSE: class for PCLMULQDQ folding CRC16 (host side bulk checksumming)
+//
+//  Results are identical to CRC16 with the same parameters, e.g.
+//
+//    ClmulCRC16<CRC16_MODBUS_POLYNOME, CRC16_MODBUS_REV_IN> crc(
+//      CRC16_MODBUS_INITIAL, CRC16_MODBUS_XOR_OUT, CRC16_MODBUS_REV_OUT);
+//
+//  Falls back to the byte table without PCLMULQDQ, see CrcClmul.h.
+
+
+#include "CrcParameters.h"
+#include "CrcClass.h"
+
+
+template <uint16_t polynome = CRC16_POLYNOME, bool reverseIn = CRC16_REV_IN>
+using ClmulCRC16 = CrcClass<16, polynome, reverseIn, CrcHardwarePolicy,
+                            CRC16_INITIAL, CRC16_XOR_OUT, CRC16_REV_OUT>;
+
+
+//  -- END OF FILE --
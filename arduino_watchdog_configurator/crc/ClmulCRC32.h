@@ -0,0 +1,23 @@
+#pragma once
+//
+//    FILE: ClmulCRC32.h
+// PURPOSE: class for PCLMULQDQ folding CRC32 (host side bulk checksumming)
+//
+//  Results are identical to CRC32 with the same parameters, e.g.
+//
+//    ClmulCRC32<CRC32_CASTAGNOLI_POLYNOME, CRC32_CASTAGNOLI_REV_IN> crc(
+//      CRC32_CASTAGNOLI_INITIAL, CRC32_CASTAGNOLI_XOR_OUT, CRC32_CASTAGNOLI_REV_OUT);
+//
+//  Falls back to slicing-by-8 without PCLMULQDQ, see CrcClmul.h.
+
+
+#include "CrcParameters.h"
+#include "CrcClass.h"
+
+
+template <uint32_t polynome = CRC32_POLYNOME, bool reverseIn = CRC32_REV_IN>
+using ClmulCRC32 = CrcClass<32, polynome, reverseIn, CrcHardwarePolicy,
+                            CRC32_INITIAL, CRC32_XOR_OUT, CRC32_REV_OUT>;
+
+
+//  -- END OF FILE --
@@ -0,0 +1,23 @@
+#pragma once
+//
+//    FILE: ClmulCRC64.h
+// PURPOSE: class for PCLMULQDQ folding CRC64 (host side bulk checksumming)
+//
+//  Results are identical to CRC64 with the same parameters, e.g.
+//
+//    ClmulCRC64<CRC64_ISO64_POLYNOME, CRC64_ISO64_REV_IN> crc(
+//      CRC64_ISO64_INITIAL, CRC64_ISO64_XOR_OUT, CRC64_ISO64_REV_OUT);
+//
+//  Falls back to slicing-by-8 without PCLMULQDQ, see CrcClmul.h.
+
+
+#include "CrcParameters.h"
+#include "CrcClass.h"
+
+
+template <uint64_t polynome = CRC64_POLYNOME, bool reverseIn = CRC64_REV_IN>
+using ClmulCRC64 = CrcClass<64, polynome, reverseIn, CrcHardwarePolicy,
+                            CRC64_INITIAL, CRC64_XOR_OUT, CRC64_REV_OUT>;
+
+
+//  -- END OF FILE --
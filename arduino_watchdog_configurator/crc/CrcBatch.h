@@ -0,0 +1,223 @@
+#pragma once
+//
+//    FILE: CrcBatch.h
+// PURPOSE: CRC of many independent short frames at once
+//
+//  crcBatch<Preset>() checksums count frames of length bytes, stride
+//  bytes apart, and writes one CRC per frame to results:
+//
+//    uint16_t crcs[1000];
+//    crcBatch<CRC_PRESET(16, CRC16)>(frames, 1000, 8, 6, crcs);
+//
+//  A single short message is one long dependency chain of table lookups.
+//  Several frames are run side by side instead: 4 interleaved scalar
+//  lanes, or on x86 CPUs with AVX2 16 lanes in two vectors of gathered
+//  table lookups. Widths up to 32 bits use the vector lanes.
+//  Results are identical to Preset::compute() on every frame.
+
+
+#include "CrcDefines.h"
+#include "CrcTable.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && !defined(ARDUINO)
+#define CRC_BATCH_AVX2 1
+#include <immintrin.h>
+#endif
+
+
+namespace crc_detail
+{
+template <typename Preset>
+struct BatchRegister
+{
+  typedef typename Preset::Type Type;
+  static const uint8_t width = Preset::getWidth();
+  static const bool reflected = Preset::getReverseIn();
+
+  static Type start()
+  {
+    return reflected ? reflect<Type>(Preset::getInitial(), width) : Preset::getInitial();
+  }
+
+  static Type finish(Type crc)
+  {
+    if (Preset::getReverseOut() != reflected) crc = reflect<Type>(crc, width);
+    return (Type)(crc ^ Preset::getXorOut()) & mask<Type>(width);
+  }
+};
+
+//  4 frames per step, the lookups of different frames are independent
+//  so they overlap in the pipeline.
+template <typename Preset>
+void batchScalar(const uint8_t *frames, size_t count, size_t stride, size_t length,
+                 typename Preset::Type *results)
+{
+  typedef BatchRegister<Preset> Register;
+  typedef typename Preset::Type T;
+  const uint8_t width = Preset::getWidth();
+
+  size_t frame = 0;
+  for (; frame + 4 <= count; frame += 4)
+  {
+    const uint8_t *f0 = frames + frame * stride;
+    const uint8_t *f1 = f0 + stride;
+    const uint8_t *f2 = f1 + stride;
+    const uint8_t *f3 = f2 + stride;
+    T c0 = Register::start();
+    T c1 = c0;
+    T c2 = c0;
+    T c3 = c0;
+    typedef CrcByteTable<T, width, Preset::getPolynome(), Register::reflected> Table;
+    for (size_t i = 0; i < length; i++)
+    {
+      if (Register::reflected)
+      {
+        c0 = (c0 >> 8) ^ Table::read((uint8_t)c0 ^ f0[i]);
+        c1 = (c1 >> 8) ^ Table::read((uint8_t)c1 ^ f1[i]);
+        c2 = (c2 >> 8) ^ Table::read((uint8_t)c2 ^ f2[i]);
+        c3 = (c3 >> 8) ^ Table::read((uint8_t)c3 ^ f3[i]);
+      }
+      else
+      {
+        const T m = mask<T>(width);
+        c0 = (T)((T)(c0 << 8) ^ Table::read((uint8_t)(c0 >> (width - 8)) ^ f0[i])) & m;
+        c1 = (T)((T)(c1 << 8) ^ Table::read((uint8_t)(c1 >> (width - 8)) ^ f1[i])) & m;
+        c2 = (T)((T)(c2 << 8) ^ Table::read((uint8_t)(c2 >> (width - 8)) ^ f2[i])) & m;
+        c3 = (T)((T)(c3 << 8) ^ Table::read((uint8_t)(c3 >> (width - 8)) ^ f3[i])) & m;
+      }
+    }
+    results[frame] = Register::finish(c0);
+    results[frame + 1] = Register::finish(c1);
+    results[frame + 2] = Register::finish(c2);
+    results[frame + 3] = Register::finish(c3);
+  }
+  for (; frame < count; frame++)
+  {
+    results[frame] = Register::finish(crcByteTableUpdate<T, width, Preset::getPolynome(), Register::reflected>(
+                                        Register::start(), frames + frame * stride, length));
+  }
+}
+
+
+#if defined(CRC_BATCH_AVX2)
+
+inline bool batchAvx2Supported()
+{
+  static const bool supported = __builtin_cpu_supports("avx2");
+  return supported;
+}
+
+//  One table step for 8 registers, byte holds the next input byte per lane.
+template <uint8_t width, bool reflected>
+__attribute__((target("avx2")))
+inline __m256i batchStep(__m256i crc, __m256i byte, const int *table)
+{
+  const __m256i low = _mm256_set1_epi32(0xFF);
+  if (reflected)
+  {
+    __m256i index = _mm256_and_si256(_mm256_xor_si256(crc, byte), low);
+    return _mm256_xor_si256(_mm256_srli_epi32(crc, 8), _mm256_i32gather_epi32(table, index, 4));
+  }
+  __m256i index = _mm256_and_si256(_mm256_xor_si256(_mm256_srli_epi32(crc, width - 8), byte), low);
+  __m256i next = _mm256_xor_si256(_mm256_slli_epi32(crc, 8), _mm256_i32gather_epi32(table, index, 4));
+  return width == 32 ? next : _mm256_and_si256(next, _mm256_set1_epi32((int)mask<uint32_t>(width)));
+}
+
+//  16 frames per step. The input is gathered 4 bytes per lane at a time,
+//  the last word is read ending at the last byte so nothing past a frame
+//  is touched. Frames shorter than 4 bytes need a stride of at least 4,
+//  the last frame is then left to the scalar code.
+template <typename Preset>
+__attribute__((target("avx2")))
+size_t batchAvx2(const uint8_t *frames, size_t count, size_t stride, size_t length,
+                 typename Preset::Type *results)
+{
+  typedef BatchRegister<Preset> Register;
+  const uint8_t width = Preset::getWidth();
+  const bool reflected = Register::reflected;
+  typedef CrcByteTable<uint32_t, width, Preset::getPolynome(), reflected> Table;
+  const int *table = (const int *)Table::values;
+
+  const __m256i offsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                                             _mm256_set1_epi32((int)stride));
+  const __m256i low = _mm256_set1_epi32(0xFF);
+
+  const size_t limit = length >= 4 ? count : count - 1;
+  size_t frame = 0;
+  for (; frame + 16 <= limit; frame += 16)
+  {
+    const uint8_t *base0 = frames + frame * stride;
+    const uint8_t *base1 = base0 + 8 * stride;
+    __m256i c0 = _mm256_set1_epi32((int)Register::start());
+    __m256i c1 = c0;
+    size_t i = 0;
+    while (i < length)
+    {
+      //  the tail word overlaps bytes already done, skip those
+      const size_t at = (i + 4 <= length || length < 4) ? i : length - 4;
+      const uint8_t skip = (uint8_t)(i - at);
+      const uint8_t end = length - at < 4 ? (uint8_t)(length - at) : 4;
+      __m256i w0 = _mm256_i32gather_epi32((const int *)(base0 + at), offsets, 1);
+      __m256i w1 = _mm256_i32gather_epi32((const int *)(base1 + at), offsets, 1);
+      for (uint8_t b = skip; b < end; b++)
+      {
+        const __m128i shift = _mm_cvtsi32_si128(8 * b);
+        c0 = batchStep<width, reflected>(c0, _mm256_and_si256(_mm256_srl_epi32(w0, shift), low), table);
+        c1 = batchStep<width, reflected>(c1, _mm256_and_si256(_mm256_srl_epi32(w1, shift), low), table);
+      }
+      i = at + 4;
+    }
+    uint32_t lanes[16];
+    _mm256_storeu_si256((__m256i *)lanes, c0);
+    _mm256_storeu_si256((__m256i *)(lanes + 8), c1);
+    for (uint8_t lane = 0; lane < 16; lane++)
+    {
+      results[frame + lane] = Register::finish((typename Preset::Type)lanes[lane]);
+    }
+  }
+  return frame;
+}
+
+#endif
+
+//  vector lanes are 32 bit
+template <typename Preset, bool = (Preset::getWidth() <= 32)>
+struct BatchVector
+{
+  static size_t run(const uint8_t *, size_t, size_t, size_t, typename Preset::Type *)
+  {
+    return 0;
+  }
+};
+
+template <typename Preset>
+struct BatchVector<Preset, true>
+{
+  static size_t run(const uint8_t *frames, size_t count, size_t stride, size_t length,
+                    typename Preset::Type *results)
+  {
+#if defined(CRC_BATCH_AVX2)
+    if (length > 0 && (length >= 4 || stride >= 4) && count > 0 &&
+        stride <= 0x7FFFFFFF / 16 && batchAvx2Supported())
+    {
+      return batchAvx2<Preset>(frames, count, stride, length, results);
+    }
+#endif
+    return 0;
+  }
+};
+}  // namespace crc_detail
+
+
+//  Preset is a Crc<> class, e.g. CRC_PRESET(16, CRC16_MODBUS).
+template <typename Preset>
+void crcBatch(const uint8_t *frames, size_t count, size_t stride, size_t length,
+              typename Preset::Type *results)
+{
+  size_t done = crc_detail::BatchVector<Preset>::run(frames, count, stride, length, results);
+  crc_detail::batchScalar<Preset>(frames + done * stride, count - done, stride, length, results + done);
+}
+
+
+//  -- END OF FILE --
+
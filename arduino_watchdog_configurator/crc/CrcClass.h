@@ -0,0 +1,107 @@
+#pragma once
+//
+//    FILE: CrcClass.h
+// PURPOSE: CRC8 .. CRC64 style class on top of Crc<> and a policy
+//
+//  Polynome, reverseIn and the implementation policy are compile time
+//  parameters as in Crc<>, initial, xorOut and reverseOut are set at
+//  run time as in the CRC8 .. CRC64 classes. The defaults of the run
+//  time parameters are template parameters too, so the named classes
+//  are plain aliases, e.g.
+//
+//    template <uint16_t polynome = CRC16_POLYNOME, bool reverseIn = CRC16_REV_IN>
+//    using TableCRC16 = CrcClass<16, polynome, reverseIn, CrcBytePolicy,
+//                                CRC16_INITIAL, CRC16_XOR_OUT, CRC16_REV_OUT>;
+//
+//  see TableCRC16.h, NibbleCRC8.h .. NibbleCRC64.h, SlicingCRC32.h,
+//  SlicingCRC64.h and ClmulCRC16.h .. ClmulCRC64.h.
+
+
+#include "CrcEngine.h"
+
+
+template <uint8_t width,
+          typename CrcUint<width>::type polynome,
+          bool reverseIn,
+          typename Policy,
+          typename CrcUint<width>::type defaultInitial,
+          typename CrcUint<width>::type defaultXorOut,
+          bool defaultReverseOut>
+class CrcClass : private Crc<width, polynome, 0, 0, reverseIn, reverseIn, Policy>
+{
+  //  the bare register, initial and xorOut are applied here
+  typedef Crc<width, polynome, 0, 0, reverseIn, reverseIn, Policy> Engine;
+
+public:
+  typedef typename Engine::Type Type;
+  typedef typename Engine::Traits Traits;
+
+  CrcClass(Type initial = defaultInitial,
+           Type xorOut  = defaultXorOut,
+           bool reverseOut = defaultReverseOut) :
+    _initial(initial),
+    _xorOut(xorOut),
+    _reverseOut(reverseOut)
+  {
+    restart();
+  }
+
+  void reset(Type initial = defaultInitial,
+             Type xorOut  = defaultXorOut,
+             bool reverseOut = defaultReverseOut)
+  {
+    _initial = initial;
+    _xorOut = xorOut;
+    _reverseOut = reverseOut;
+    restart();
+  }
+
+  void restart()
+  {
+    this->_crc = reverseIn ? crc_detail::reflect<Type>(_initial, width) : _initial;
+    _count = 0u;
+  }
+
+  Type calc() const
+  {
+    Type rv = Engine::calc();
+    //  a reflected register already is the reversed output
+    if (_reverseOut != reverseIn) rv = crc_detail::reverseBits(rv, width);
+    return (Type)(rv ^ _xorOut) & crc_detail::mask<Type>(width);
+  }
+
+  crc_size_t count() const { return _count; }
+
+  void add(uint8_t value)
+  {
+    _count++;
+    Engine::add(value);
+  }
+
+  void add(const uint8_t *array, crc_size_t length)
+  {
+    _count += length;
+    Engine::add(array, length);
+  }
+
+  void add(const uint8_t *array, crc_size_t length, crc_size_t yieldPeriod)
+  {
+    _count += length;
+    Engine::add(array, length, yieldPeriod);
+  }
+
+  Type getPolynome() const { return polynome; }
+  Type getInitial() const { return _initial; }
+  Type getXorOut() const { return _xorOut; }
+  bool getReverseIn() const { return reverseIn; }
+  bool getReverseOut() const { return _reverseOut; }
+
+private:
+  Type _initial;
+  Type _xorOut;
+  bool _reverseOut;
+  crc_size_t _count;
+};
+
+
+//  -- END OF FILE --
@@ -0,0 +1,220 @@
+#pragma once
+//
+//    FILE: CrcClmul.h
+// PURPOSE: carry-less multiply (PCLMULQDQ) folding kernel for CRC16, CRC32, CRC64
+//
+//  The buffer is folded 64 bytes per step into four 128 bit lanes:
+//  a lane L followed by N bits is replaced by L_hi * (x^(N+64) mod P)
+//  + L_lo * (x^N mod P), which leaves the CRC unchanged. The last 16 byte
+//  lane and the tail go through the byte table kernel.
+//  The fold constants are computed by the compiler from the polynome,
+//  so every normal and reflected preset in CrcParameters.h is supported.
+//
+//  On CPUs without PCLMULQDQ, and on non x86 builds, the portable
+//  slicing-by-8 (CRC32, CRC64) or byte table (CRC16) kernel is used.
+
+
+#include "CrcDefines.h"
+#include "CrcTable.h"
+#include "CrcSlicing.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define CRC_CLMUL_X86 1
+#include <immintrin.h>
+#endif
+
+
+namespace crc_detail
+{
+//  Polynome arithmetic modulo P = x^width + polynome, width <= 64.
+
+constexpr uint64_t clmulMask(uint8_t width)
+{
+  return width >= 64 ? ~(uint64_t)0 : ((uint64_t)1 << width) - 1;
+}
+
+//  a * x mod P
+constexpr uint64_t clmulTimesX(uint64_t a, uint64_t polynome, uint8_t width)
+{
+  return ((a << 1) & clmulMask(width)) ^ (((a >> (width - 1)) & 1) ? polynome : 0);
+}
+
+//  a * b mod P, walking the bits of b from the top
+constexpr uint64_t clmulMulMod(uint64_t a, uint64_t b, uint64_t polynome, uint8_t width,
+                               int8_t bit, uint64_t result)
+{
+  return bit < 0 ? result
+       : clmulMulMod(a, b, polynome, width, bit - 1,
+                     clmulTimesX(result, polynome, width) ^ (((b >> bit) & 1) ? a : 0));
+}
+
+constexpr uint64_t clmulSquareMod(uint64_t a, uint64_t polynome, uint8_t width)
+{
+  return clmulMulMod(a, a, polynome, width, width - 1, 0);
+}
+
+//  x^n mod P
+constexpr uint64_t clmulPowMod(uint16_t n, uint64_t polynome, uint8_t width)
+{
+  return n == 0 ? 1
+       : (n & 1) ? clmulTimesX(clmulPowMod(n - 1, polynome, width), polynome, width)
+       : clmulSquareMod(clmulPowMod(n / 2, polynome, width), polynome, width);
+}
+
+//  Fold constant for x^n. A reflected lane is the bit reversed 128 bit
+//  value and carry-less products of reversed operands come out one bit
+//  short, which is compensated by using x^(n-1).
+constexpr uint64_t clmulFoldConstant(uint16_t n, uint64_t polynome, uint8_t width, bool reflected)
+{
+  return reflected ? reflect<uint64_t>(clmulPowMod(n - 1, polynome, width), 64)
+                   : clmulPowMod(n, polynome, width);
+}
+
+
+struct SlicingKernel {};
+struct ByteTableKernel {};
+
+template <typename T, uint8_t width, T polynome, bool reflected>
+T portableUpdate(T crc, const uint8_t *array, crc_size_t length, SlicingKernel)
+{
+  return crcSlicingUpdate<T, width, polynome, reflected, 8>(crc, array, length);
+}
+
+template <typename T, uint8_t width, T polynome, bool reflected>
+T portableUpdate(T crc, const uint8_t *array, crc_size_t length, ByteTableKernel)
+{
+  return crcByteTableUpdate<T, width, polynome, reflected>(crc, array, length);
+}
+
+template <uint8_t width>
+struct PortableKernel
+{
+  typedef ByteTableKernel type;
+};
+
+template <>
+struct PortableKernel<32>
+{
+  typedef SlicingKernel type;
+};
+
+template <>
+struct PortableKernel<64>
+{
+  typedef SlicingKernel type;
+};
+
+
+#if defined(CRC_CLMUL_X86)
+
+inline bool clmulSupported()
+{
+  static const bool supported = __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("ssse3");
+  return supported;
+}
+
+template <bool reflected, uint64_t hi, uint64_t lo>
+__attribute__((target("pclmul,ssse3")))
+inline __m128i clmulFold(__m128i lane, __m128i next)
+{
+  //  lane 1 holds the high half of a normal value, lane 0 the (reversed)
+  //  high half of a reflected value
+  const __m128i k = reflected ? _mm_set_epi64x((long long)lo, (long long)hi)
+                              : _mm_set_epi64x((long long)hi, (long long)lo);
+  return _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(lane, k, 0x00),
+                                     _mm_clmulepi64_si128(lane, k, 0x11)), next);
+}
+
+//  Normal CRCs take the first byte as the highest coefficient,
+//  so their lanes are kept byte swapped.
+template <bool reflected>
+__attribute__((target("pclmul,ssse3")))
+inline __m128i clmulByteOrder(__m128i block)
+{
+  if (reflected) return block;
+  return _mm_shuffle_epi8(block, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7,
+                                              8, 9, 10, 11, 12, 13, 14, 15));
+}
+
+template <bool reflected>
+__attribute__((target("pclmul,ssse3")))
+inline __m128i clmulLoad(const uint8_t *array)
+{
+  return clmulByteOrder<reflected>(_mm_loadu_si128((const __m128i *)array));
+}
+
+template <typename T, uint8_t width, T polynome, bool reflected>
+__attribute__((target("pclmul,ssse3")))
+T clmulUpdate(T crc, const uint8_t *array, crc_size_t length)
+{
+  #define CRC_FOLD_CONSTANTS(bits) \
+    clmulFoldConstant((bits) + 64, polynome, width, reflected), \
+    clmulFoldConstant((bits), polynome, width, reflected)
+
+  __m128i lane0 = clmulLoad<reflected>(array);
+  __m128i lane1 = clmulLoad<reflected>(array + 16);
+  __m128i lane2 = clmulLoad<reflected>(array + 32);
+  __m128i lane3 = clmulLoad<reflected>(array + 48);
+
+  //  the register is added to the first width bits of the message
+  lane0 = _mm_xor_si128(lane0, reflected
+            ? _mm_set_epi64x(0, (long long)crc)
+            : _mm_set_epi64x((long long)((uint64_t)crc << (64 - width)), 0));
+  array += 64;
+  length -= 64;
+
+  while (length >= 64)
+  {
+    lane0 = clmulFold<reflected, CRC_FOLD_CONSTANTS(512)>(lane0, clmulLoad<reflected>(array));
+    lane1 = clmulFold<reflected, CRC_FOLD_CONSTANTS(512)>(lane1, clmulLoad<reflected>(array + 16));
+    lane2 = clmulFold<reflected, CRC_FOLD_CONSTANTS(512)>(lane2, clmulLoad<reflected>(array + 32));
+    lane3 = clmulFold<reflected, CRC_FOLD_CONSTANTS(512)>(lane3, clmulLoad<reflected>(array + 48));
+    array += 64;
+    length -= 64;
+  }
+
+  __m128i lane = clmulFold<reflected, CRC_FOLD_CONSTANTS(384)>(lane0,
+                 clmulFold<reflected, CRC_FOLD_CONSTANTS(256)>(lane1,
+                 clmulFold<reflected, CRC_FOLD_CONSTANTS(128)>(lane2, lane3)));
+
+  while (length >= 16)
+  {
+    lane = clmulFold<reflected, CRC_FOLD_CONSTANTS(128)>(lane, clmulLoad<reflected>(array));
+    array += 16;
+    length -= 16;
+  }
+  #undef CRC_FOLD_CONSTANTS
+
+  //  the folded lane replaces the message so far, finish with the tables
+  uint8_t folded[16];
+  _mm_storeu_si128((__m128i *)folded, clmulByteOrder<reflected>(lane));
+  crc = crcByteTableUpdate<T, width, polynome, reflected>(0, folded, sizeof(folded));
+  return crcByteTableUpdate<T, width, polynome, reflected>(crc, array, length);
+}
+
+#endif
+}  // namespace crc_detail
+
+
+//  Runs the register crc over array and returns the new register.
+//  The register is reflected (right shifting) when reflected is set.
+template <typename T, uint8_t width, T polynome, bool reflected>
+T crcClmulUpdate(T crc, const uint8_t *array, crc_size_t length)
+{
+  static_assert(width == 16 || width == 32 || width == 64, "folding is implemented for CRC16, CRC32 and CRC64");
+  static_assert(width == 8 * sizeof(T), "folding needs a full width register");
+
+#if defined(CRC_CLMUL_X86)
+  //  below two blocks the table kernels are faster
+  if (length >= 128 && crc_detail::clmulSupported())
+  {
+    return crc_detail::clmulUpdate<T, width, polynome, reflected>(crc, array, length);
+  }
+#endif
+  return crc_detail::portableUpdate<T, width, polynome, reflected>(crc, array, length,
+           typename crc_detail::PortableKernel<width>::type());
+}
+
+
+//  -- END OF FILE --
+
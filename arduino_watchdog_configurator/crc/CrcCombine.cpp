@@ -0,0 +1,51 @@
+//
+//    FILE: CrcCombine.cpp
+// PURPOSE: combine the CRCs of two blocks into the CRC of their concatenation
+
+
+#include "CrcCombine.h"
+
+
+uint8_t combineCRC8(
+  uint8_t crcA, uint8_t crcB, crc_size_t lengthB,
+  uint8_t polynome, uint8_t initial, uint8_t xorOut,
+  bool, bool reverseOut)
+{
+  return crc_detail::combine<uint8_t>(crcA, crcB, lengthB, polynome, initial, xorOut, reverseOut, 8);
+}
+
+uint16_t combineCRC12(
+  uint16_t crcA, uint16_t crcB, crc_size_t lengthB,
+  uint16_t polynome, uint16_t initial, uint16_t xorOut,
+  bool, bool reverseOut)
+{
+  return crc_detail::combine<uint16_t>(crcA, crcB, lengthB, polynome, initial, xorOut, reverseOut, 12);
+}
+
+uint16_t combineCRC16(
+  uint16_t crcA, uint16_t crcB, crc_size_t lengthB,
+  uint16_t polynome, uint16_t initial, uint16_t xorOut,
+  bool, bool reverseOut)
+{
+  return crc_detail::combine<uint16_t>(crcA, crcB, lengthB, polynome, initial, xorOut, reverseOut, 16);
+}
+
+uint32_t combineCRC32(
+  uint32_t crcA, uint32_t crcB, crc_size_t lengthB,
+  uint32_t polynome, uint32_t initial, uint32_t xorOut,
+  bool, bool reverseOut)
+{
+  return crc_detail::combine<uint32_t>(crcA, crcB, lengthB, polynome, initial, xorOut, reverseOut, 32);
+}
+
+uint64_t combineCRC64(
+  uint64_t crcA, uint64_t crcB, crc_size_t lengthB,
+  uint64_t polynome, uint64_t initial, uint64_t xorOut,
+  bool, bool reverseOut)
+{
+  return crc_detail::combine<uint64_t>(crcA, crcB, lengthB, polynome, initial, xorOut, reverseOut, 64);
+}
+
+
+//  -- END OF FILE --
+
@@ -0,0 +1,140 @@
+#pragma once
+//
+//    FILE: CrcCombine.h
+// PURPOSE: combine the CRCs of two blocks into the CRC of their concatenation
+//
+//  combineCRC16(crcA, crcB, lengthB, ...) returns the CRC of A followed
+//  by B, given only the CRCs of A and B and the length of B, for the same
+//  preset parameters. Chunks can be checksummed independently (e.g. on
+//  several cores) and merged, or a stored CRC extended with new data.
+//  The cost is O(log lengthB) polynome multiplications, not O(lengthB).
+
+
+#include "CrcParameters.h"
+#include "CrcDefines.h"
+#include "CrcFastReverse.h"
+
+
+namespace crc_detail
+{
+//  run time bit reversal of a width bit register
+inline uint8_t reverseBits(uint8_t value, uint8_t)
+{
+  return reverse8bits(value);
+}
+
+inline uint16_t reverseBits(uint16_t value, uint8_t width)
+{
+  return width == 12 ? reverse12bits(value) : (uint16_t)(reverse16bits(value) >> (16 - width));
+}
+
+inline uint32_t reverseBits(uint32_t value, uint8_t width)
+{
+  return reverse32bits(value) >> (32 - width);
+}
+
+inline uint64_t reverseBits(uint64_t value, uint8_t width)
+{
+  return reverse64bits(value) >> (64 - width);
+}
+
+//  a * b mod P, P = x^width + polynome, not reflected
+template <typename T>
+T multiplyMod(T a, T b, T polynome, uint8_t width)
+{
+  const T topBit = (T)((T)1 << (width - 1));
+  T product = 0;
+  for (T bit = topBit; bit != 0; bit >>= 1)
+  {
+    product = (product & topBit) ? (T)((T)(product << 1) ^ polynome) : (T)(product << 1);
+    if (b & bit) product ^= a;
+  }
+  return product & (T)(topBit | (topBit - 1));
+}
+
+//  crc * x^(8 * bytes) mod P, the register after bytes zero bytes
+//  when the initial value and input are not counted
+template <typename T>
+T shiftZeros(T crc, T polynome, uint8_t width, crc_size_t bytes)
+{
+  //  x^8 mod P
+  T x8 = 1;
+  for (uint8_t i = 0; i < 8; i++)
+  {
+    x8 = multiplyMod<T>(x8, (T)2, polynome, width);
+  }
+  T power = 1;
+  for (int8_t bit = 8 * sizeof(crc_size_t) - 1; bit >= 0; bit--)
+  {
+    power = multiplyMod<T>(power, power, polynome, width);
+    if ((bytes >> bit) & 1) power = multiplyMod<T>(power, x8, polynome, width);
+  }
+  return multiplyMod<T>(crc, power, polynome, width);
+}
+
+//  The registers of A, B and A + B satisfy
+//    reg(A + B) = (reg(A) ^ initial) * x^(8 * lengthB) ^ reg(B)
+//  in the not reflected domain, which does not depend on reverseIn.
+template <typename T>
+T combine(T crcA, T crcB, crc_size_t lengthB, T polynome, T initial, T xorOut,
+          bool reverseOut, uint8_t width)
+{
+  crcA ^= xorOut;
+  crcB ^= xorOut;
+  if (reverseOut)
+  {
+    crcA = reverseBits(crcA, width);
+    crcB = reverseBits(crcB, width);
+  }
+  T crc = shiftZeros<T>(crcA ^ initial, polynome, width, lengthB) ^ crcB;
+  if (reverseOut) crc = reverseBits(crc, width);
+  return crc ^ xorOut;
+}
+}  // namespace crc_detail
+
+
+//  reverseIn does not change the result, it is accepted so that all
+//  preset parameters can be passed the same way as to calcCRC*().
+uint8_t combineCRC8(
+    uint8_t crcA, uint8_t crcB, crc_size_t lengthB,
+    uint8_t polynome   = CRC8_POLYNOME,
+    uint8_t initial    = CRC8_INITIAL,
+    uint8_t xorOut     = CRC8_XOR_OUT,
+    bool reverseIn     = CRC8_REV_IN,
+    bool reverseOut    = CRC8_REV_OUT);
+
+uint16_t combineCRC12(
+    uint16_t crcA, uint16_t crcB, crc_size_t lengthB,
+    uint16_t polynome  = CRC12_POLYNOME,
+    uint16_t initial   = CRC12_INITIAL,
+    uint16_t xorOut    = CRC12_XOR_OUT,
+    bool reverseIn     = CRC12_REV_IN,
+    bool reverseOut    = CRC12_REV_OUT);
+
+uint16_t combineCRC16(
+    uint16_t crcA, uint16_t crcB, crc_size_t lengthB,
+    uint16_t polynome  = CRC16_POLYNOME,
+    uint16_t initial   = CRC16_INITIAL,
+    uint16_t xorOut    = CRC16_XOR_OUT,
+    bool reverseIn     = CRC16_REV_IN,
+    bool reverseOut    = CRC16_REV_OUT);
+
+uint32_t combineCRC32(
+    uint32_t crcA, uint32_t crcB, crc_size_t lengthB,
+    uint32_t polynome  = CRC32_POLYNOME,
+    uint32_t initial   = CRC32_INITIAL,
+    uint32_t xorOut    = CRC32_XOR_OUT,
+    bool reverseIn     = CRC32_REV_IN,
+    bool reverseOut    = CRC32_REV_OUT);
+
+uint64_t combineCRC64(
+    uint64_t crcA, uint64_t crcB, crc_size_t lengthB,
+    uint64_t polynome  = CRC64_POLYNOME,
+    uint64_t initial   = CRC64_INITIAL,
+    uint64_t xorOut    = CRC64_XOR_OUT,
+    bool reverseIn     = CRC64_REV_IN,
+    bool reverseOut    = CRC64_REV_OUT);
+
+
+//  -- END OF FILE --
+
@@ -6,7 +6,20 @@
 //     URL: https://github.com/RobTillaart/CRC
 
 
+#ifdef ARDUINO
 #include <Arduino.h>
+#else
+//  host builds (benchmarks, tools) have no Arduino core
+#include <stddef.h>
+#include <stdint.h>
+#include <chrono>
+inline void yield() {}
+inline uint32_t micros()
+{
+  return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+           std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#endif
 
 
 #if defined(CRC_CUSTOM_SIZE)
@@ -0,0 +1,249 @@
+#pragma once
+//
+//    FILE: CrcEngine.h
+// PURPOSE: CRC class with the preset as compile time parameters
+//
+//  Crc<width, polynome, initial, xorOut, reverseIn, reverseOut> only holds
+//  the running register, every parameter is a constant so the compiler
+//  folds the reflection branches and picks the table at compile time.
+//  CRC_PRESET() names a preset from CrcParameters.h:
+//
+//    CRC_PRESET(16, CRC16_MODBUS) crc;
+//    crc.add(array, length);
+//    uint16_t value = crc.calc();
+//
+//    uint16_t value = CRC_PRESET(16, CRC16_MODBUS)::compute(array, length);
+//
+//    static_assert(CRC_PRESET(16, CRC16_MODBUS)::constant("123456789", 9) == 0x4B37, "");
+//
+//  constant() is evaluated by the compiler for constant messages,
+//  one recursion level per byte, so it is meant for short messages.
+//
+//  A received frame, message followed by its CRC, is checked in one pass
+//  over all bytes: the CRC of an intact frame is the constant residue()
+//  of the preset, whatever the message.
+//
+//    bool intact = CRC_PRESET(16, CRC16_MODBUS)::verify(frame, sizeof(frame));
+//
+//  The last parameter selects the implementation, see CrcPolicy.h;
+//  CRC_PRESET() uses the byte table, CRC_PRESET_POLICY() names one:
+//
+//    CRC_PRESET_POLICY(16, CRC16_MODBUS, CrcNibblePolicy) crc;
+
+
+#include "CrcParameters.h"
+#include "CrcDefines.h"
+#include "CrcFastReverse.h"
+#include "CrcTable.h"
+#include "CrcPolicy.h"
+#include "CrcCombine.h"
+#include "CrcSegment.h"
+
+
+#define CRC_PRESET(width, name) \
+  Crc<width, name##_POLYNOME, name##_INITIAL, name##_XOR_OUT, name##_REV_IN, name##_REV_OUT>
+
+#define CRC_PRESET_POLICY(width, name, policy) \
+  Crc<width, name##_POLYNOME, name##_INITIAL, name##_XOR_OUT, name##_REV_IN, name##_REV_OUT, policy>
+
+
+//  smallest register type for a CRC width
+template <uint8_t width, bool = (width <= 8), bool = (width <= 16), bool = (width <= 32)>
+struct CrcUint
+{
+  typedef uint64_t type;
+};
+
+template <uint8_t width, bool b16, bool b32>
+struct CrcUint<width, true, b16, b32>
+{
+  typedef uint8_t type;
+};
+
+template <uint8_t width, bool b32>
+struct CrcUint<width, false, true, b32>
+{
+  typedef uint16_t type;
+};
+
+template <uint8_t width>
+struct CrcUint<width, false, false, true>
+{
+  typedef uint32_t type;
+};
+
+
+template <uint8_t width,
+          typename CrcUint<width>::type polynome,
+          typename CrcUint<width>::type initial,
+          typename CrcUint<width>::type xorOut,
+          bool reverseIn,
+          bool reverseOut,
+          typename Policy = CrcBytePolicy>
+class Crc
+{
+public:
+  typedef typename CrcUint<width>::type Type;
+  typedef CrcPolicyTraits<Policy, Type, width, polynome, reverseIn> Traits;
+
+  static_assert(width >= 8 && width <= 64, "Crc supports widths from 8 to 64 bits");
+
+  Crc() : _crc(start()) {}
+
+  void restart() { _crc = start(); }
+
+  Type calc() const
+  {
+    Type rv = _crc;
+    //  a reflected register already is the reversed output
+    if (reverseOut != reverseIn) rv = crc_detail::reverseBits(rv, width);
+    return (Type)(rv ^ xorOut) & crc_detail::mask<Type>(width);
+  }
+
+  void add(uint8_t value)
+  {
+    _crc = Traits::update(_crc, &value, 1);
+  }
+
+  void add(const uint8_t *array, crc_size_t length)
+  {
+    _crc = Traits::update(_crc, array, length);
+  }
+
+  void add(const uint8_t *array, crc_size_t length, crc_size_t yieldPeriod)
+  {
+    if (yieldPeriod == CRC_YIELD_DISABLED)
+    {
+      add(array, length);
+      return;
+    }
+    while (length > 0)
+    {
+      crc_size_t part = length < yieldPeriod ? length : yieldPeriod;
+      add(array, part);
+      array += part;
+      length -= part;
+      if (part == yieldPeriod) yield();
+    }
+  }
+
+  //  count segments in message order, see CrcSegment.h
+  void add(const CrcSegment *segments, crc_size_t count)
+  {
+    while (count--)
+    {
+      add(segments->data, segments->length);
+      segments++;
+    }
+  }
+
+  //  yields when yieldMicros passed, checked every CRC_TIMED_CHUNK bytes
+  void addTimed(const uint8_t *array, crc_size_t length, uint32_t yieldMicros)
+  {
+    uint32_t start = micros();
+    while (length > 0)
+    {
+      crc_size_t part = length < CRC_TIMED_CHUNK ? length : CRC_TIMED_CHUNK;
+      add(array, part);
+      array += part;
+      length -= part;
+      if (micros() - start >= yieldMicros)
+      {
+        yield();
+        start = micros();
+      }
+    }
+  }
+
+  static Type compute(const uint8_t *array, crc_size_t length)
+  {
+    Crc crc;
+    crc.add(array, length);
+    return crc.calc();
+  }
+
+  //  CRC of A followed by B from the CRCs of A and B, see CrcCombine.h
+  static Type combine(Type crcA, Type crcB, crc_size_t lengthB)
+  {
+    return crc_detail::combine<Type>(crcA, crcB, lengthB, polynome, initial, xorOut, reverseOut, width);
+  }
+
+  //  calc() of a message followed by its CRC, sent most significant byte
+  //  first, or least significant byte first for reflected presets; the
+  //  catalogue residue is the register before xorOut, this one is after
+  static constexpr Type residue()
+  {
+    static_assert(width % 8 == 0, "residue() needs a CRC of whole bytes");
+    static_assert(reverseIn == reverseOut, "residue() needs reverseIn == reverseOut");
+    return finish(appendCrc(start(), finish(start()), 0));
+  }
+
+  //  true when the bytes added so far end with their own CRC
+  bool verify() const { return calc() == residue(); }
+
+  static bool verify(const uint8_t *frame, crc_size_t length)
+  {
+    return compute(frame, length) == residue();
+  }
+
+  static constexpr Type constant(const uint8_t *array, crc_size_t length)
+  {
+    return finish(constantAdd(start(), array, length));
+  }
+
+  static constexpr Type constant(const char *text, crc_size_t length)
+  {
+    return finish(constantAdd(start(), text, length));
+  }
+
+  static constexpr uint8_t getWidth() { return width; }
+  static constexpr Type getPolynome() { return polynome; }
+  static constexpr Type getInitial() { return initial; }
+  static constexpr Type getXorOut() { return xorOut; }
+  static constexpr bool getReverseIn() { return reverseIn; }
+  static constexpr bool getReverseOut() { return reverseOut; }
+
+private:
+  //  reflected register when reverseIn is set
+  static constexpr Type start()
+  {
+    return reverseIn ? crc_detail::reflect<Type>(initial, width) : initial;
+  }
+
+  static constexpr Type finish(Type crc)
+  {
+    return (Type)((reverseOut != reverseIn ? crc_detail::reflect<Type>(crc, width) : crc) ^ xorOut)
+           & crc_detail::mask<Type>(width);
+  }
+
+  static constexpr Type constantByte(Type crc, uint8_t value)
+  {
+    return reverseIn
+         ? (Type)((crc >> 8) ^ crc_detail::byteTableEntry<Type, width, polynome, true>((uint8_t)(crc ^ value)))
+         : (Type)(((Type)(crc << 8) ^ crc_detail::byteTableEntry<Type, width, polynome, false>(
+                     (uint8_t)((crc >> (width - 8)) ^ value))) & crc_detail::mask<Type>(width));
+  }
+
+  template <typename Byte>
+  static constexpr Type constantAdd(Type crc, const Byte *array, crc_size_t length)
+  {
+    return length == 0 ? crc : constantAdd(constantByte(crc, (uint8_t)*array), array + 1, length - 1);
+  }
+
+  //  the bytes of value in transmission order, see residue()
+  static constexpr Type appendCrc(Type crc, Type value, uint8_t index)
+  {
+    return index == width / 8 ? crc
+         : appendCrc(constantByte(crc, (uint8_t)(reverseIn ? value >> (8 * index)
+                                                           : value >> (width - 8 * (index + 1)))),
+                     value, index + 1);
+  }
+
+protected:
+  //  reflected register when reverseIn is set, see CrcClass.h
+  Type _crc;
+};
+
+
+//  -- END OF FILE --
+
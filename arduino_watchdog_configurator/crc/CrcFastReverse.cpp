@@ -7,24 +7,46 @@
 
 #include "CrcFastReverse.h"
 
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && !defined(ARDUINO)
+#define CRC_REVERSE_X86 1
+#include <immintrin.h>
+#endif
+
+//  clang has bit reversal builtins, gcc does not
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_bitreverse8) && __has_builtin(__builtin_bitreverse64)
+#define CRC_REVERSE_BUILTIN 1
+#endif
+#endif
+
 
 uint8_t reverse8bits(uint8_t in)
 {
+#if defined(CRC_REVERSE_BUILTIN)
+  return __builtin_bitreverse8(in);
+#else
   uint8_t x = in;
   x = (((x & 0xAA) >> 1) | ((x & 0x55) << 1));
   x = (((x & 0xCC) >> 2) | ((x & 0x33) << 2));
   x =          ((x >> 4) | (x << 4));
   return x;
+#endif
 }
 
 uint16_t reverse16bits(uint16_t in)
 {
+#if defined(CRC_REVERSE_BUILTIN)
+  return __builtin_bitreverse16(in);
+#else
   uint16_t x = in;
   x = (((x & 0XAAAA) >> 1) | ((x & 0X5555) << 1));
   x = (((x & 0xCCCC) >> 2) | ((x & 0X3333) << 2));
   x = (((x & 0xF0F0) >> 4) | ((x & 0X0F0F) << 4));
   x = (( x >> 8) | (x << 8));
   return x;
+#endif
 }
 
 uint16_t reverse12bits(uint16_t in)
@@ -34,6 +56,9 @@ uint16_t reverse12bits(uint16_t in)
 
 uint32_t reverse32bits(uint32_t in)
 {
+#if defined(CRC_REVERSE_BUILTIN)
+  return __builtin_bitreverse32(in);
+#else
   uint32_t x = in;
   x = (((x & 0xAAAAAAAA) >> 1)  | ((x & 0x55555555) << 1));
   x = (((x & 0xCCCCCCCC) >> 2)  | ((x & 0x33333333) << 2));
@@ -41,10 +66,14 @@ uint32_t reverse32bits(uint32_t in)
   x = (((x & 0xFF00FF00) >> 8)  | ((x & 0x00FF00FF) << 8));
   x = (x >> 16) | (x << 16);
   return x;
+#endif
 }
 
 uint64_t reverse64bits(uint64_t in)
 {
+#if defined(CRC_REVERSE_BUILTIN)
+  return __builtin_bitreverse64(in);
+#else
   uint64_t x = in;
   x = (((x & 0xAAAAAAAAAAAAAAAA) >> 1)  | ((x & 0x5555555555555555) << 1));
   x = (((x & 0xCCCCCCCCCCCCCCCC) >> 2)  | ((x & 0x3333333333333333) << 2));
@@ -53,6 +82,139 @@ uint64_t reverse64bits(uint64_t in)
   x = (((x & 0xFFFF0000FFFF0000) >> 16) | ((x & 0x0000FFFF0000FFFF) << 16));
   x = (x >> 32) | (x << 32);
   return x;
+#endif
+}
+
+
+//  8 bytes at a time, bit reversal of the word also reverses the byte order
+static void reverse8bitsScalar(uint8_t *out, const uint8_t *in, crc_size_t length)
+{
+#if !defined(__AVR__)
+  while (length >= 8)
+  {
+    uint64_t word;
+    memcpy(&word, in, sizeof(word));
+    word = __builtin_bswap64(reverse64bits(word));
+    memcpy(out, &word, sizeof(word));
+    in += 8;
+    out += 8;
+    length -= 8;
+  }
+#endif
+  while (length--)
+  {
+    *out++ = reverse8bits(*in++);
+  }
+}
+
+#if defined(CRC_REVERSE_X86)
+
+__attribute__((target("ssse3")))
+static void reverse8bitsSsse3(uint8_t *out, const uint8_t *in, crc_size_t length)
+{
+  const __m128i low = _mm_setr_epi8(0x00, 0x08, 0x04, 0x0C, 0x02, 0x0A, 0x06, 0x0E,
+                                    0x01, 0x09, 0x05, 0x0D, 0x03, 0x0B, 0x07, 0x0F);
+  const __m128i lowTable = _mm_slli_epi16(low, 4);
+  const __m128i highTable = low;
+  const __m128i nibble = _mm_set1_epi8(0x0F);
+  while (length >= 16)
+  {
+    __m128i x = _mm_loadu_si128((const __m128i *)in);
+    __m128i y = _mm_or_si128(_mm_shuffle_epi8(lowTable, _mm_and_si128(x, nibble)),
+                             _mm_shuffle_epi8(highTable, _mm_and_si128(_mm_srli_epi16(x, 4), nibble)));
+    _mm_storeu_si128((__m128i *)out, y);
+    in += 16;
+    out += 16;
+    length -= 16;
+  }
+  reverse8bitsScalar(out, in, length);
+}
+
+__attribute__((target("avx2")))
+static void reverse8bitsAvx2(uint8_t *out, const uint8_t *in, crc_size_t length)
+{
+  const __m256i low = _mm256_setr_epi8(0x00, 0x08, 0x04, 0x0C, 0x02, 0x0A, 0x06, 0x0E,
+                                       0x01, 0x09, 0x05, 0x0D, 0x03, 0x0B, 0x07, 0x0F,
+                                       0x00, 0x08, 0x04, 0x0C, 0x02, 0x0A, 0x06, 0x0E,
+                                       0x01, 0x09, 0x05, 0x0D, 0x03, 0x0B, 0x07, 0x0F);
+  const __m256i lowTable = _mm256_slli_epi16(low, 4);
+  const __m256i highTable = low;
+  const __m256i nibble = _mm256_set1_epi8(0x0F);
+  while (length >= 32)
+  {
+    __m256i x = _mm256_loadu_si256((const __m256i *)in);
+    __m256i y = _mm256_or_si256(_mm256_shuffle_epi8(lowTable, _mm256_and_si256(x, nibble)),
+                                _mm256_shuffle_epi8(highTable, _mm256_and_si256(_mm256_srli_epi16(x, 4), nibble)));
+    _mm256_storeu_si256((__m256i *)out, y);
+    in += 32;
+    out += 32;
+    length -= 32;
+  }
+  reverse8bitsSsse3(out, in, length);
+}
+
+//  one affine transform per 64 bytes, the matrix maps bit i to bit 7 - i
+__attribute__((target("gfni,avx512f,avx512bw,avx2,ssse3")))
+static void reverse8bitsGfni(uint8_t *out, const uint8_t *in, crc_size_t length)
+{
+  const __m512i matrix = _mm512_set1_epi64(0x8040201008040201LL);
+  while (length >= 64)
+  {
+    __m512i x = _mm512_loadu_si512((const void *)in);
+    _mm512_storeu_si512((void *)out, _mm512_gf2p8affine_epi64_epi8(x, matrix, 0));
+    in += 64;
+    out += 64;
+    length -= 64;
+  }
+  reverse8bitsAvx2(out, in, length);
+}
+
+typedef void (*Reverse8bitsKernel)(uint8_t *out, const uint8_t *in, crc_size_t length);
+
+static Reverse8bitsKernel reverse8bitsKernel()
+{
+  if (__builtin_cpu_supports("gfni") && __builtin_cpu_supports("avx512bw")) return reverse8bitsGfni;
+  if (__builtin_cpu_supports("avx2")) return reverse8bitsAvx2;
+  if (__builtin_cpu_supports("ssse3")) return reverse8bitsSsse3;
+  return reverse8bitsScalar;
+}
+
+#endif
+
+void reverse8bits(uint8_t *out, const uint8_t *in, crc_size_t length)
+{
+#if defined(CRC_REVERSE_X86)
+  static const Reverse8bitsKernel kernel = reverse8bitsKernel();
+  kernel(out, in, length);
+#else
+  reverse8bitsScalar(out, in, length);
+#endif
+}
+
+bool crc_detail::reverse8bitsUsing(uint8_t kernel, uint8_t *out, const uint8_t *in, crc_size_t length)
+{
+  switch (kernel)
+  {
+    case 0:
+      reverse8bitsScalar(out, in, length);
+      return true;
+#if defined(CRC_REVERSE_X86)
+    case 1:
+      if (!__builtin_cpu_supports("ssse3")) return false;
+      reverse8bitsSsse3(out, in, length);
+      return true;
+    case 2:
+      if (!__builtin_cpu_supports("avx2")) return false;
+      reverse8bitsAvx2(out, in, length);
+      return true;
+    case 3:
+      if (!__builtin_cpu_supports("gfni") || !__builtin_cpu_supports("avx512bw")) return false;
+      reverse8bitsGfni(out, in, length);
+      return true;
+#endif
+    default:
+      return false;
+  }
 }
 
 
@@ -6,7 +6,7 @@
 //     URL: https://github.com/RobTillaart/CRC
 
 
-#include "Arduino.h"
+#include "CrcDefines.h"
 
 uint8_t reverse8bits(uint8_t in);
 uint16_t reverse16bits(uint16_t in);
@@ -14,6 +14,17 @@ uint16_t reverse12bits(uint16_t in);
 uint32_t reverse32bits(uint32_t in);
 uint64_t reverse64bits(uint64_t in);
 
+//  reverses the bits of every byte, out may be the same buffer as in;
+//  uses SSSE3, AVX2 or GFNI when the CPU has them
+void reverse8bits(uint8_t *out, const uint8_t *in, crc_size_t length);
+
+namespace crc_detail
+{
+//  one buffer kernel by number, for testing: 0 scalar, 1 SSSE3, 2 AVX2,
+//  3 GFNI; false when it is not built or the CPU lacks it
+bool reverse8bitsUsing(uint8_t kernel, uint8_t *out, const uint8_t *in, crc_size_t length);
+}
+
 [[deprecated("Use reverse8bits() instead")]] uint8_t reverse8(uint8_t in);
 [[deprecated("Use reverse12bits() instead")]] uint16_t reverse16(uint16_t in);
 [[deprecated("Use reverse16bits() instead")]] uint16_t reverse12(uint16_t in);
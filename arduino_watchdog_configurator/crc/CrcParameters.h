@@ -11,6 +11,11 @@
 
 #define CRC_YIELD_DISABLED         0
 
+//  bytes processed between two clock checks of addTimed()
+#ifndef CRC_TIMED_CHUNK
+#define CRC_TIMED_CHUNK            16
+#endif
+
 
 //  CRC 4
 #define CRC4_POLYNOME               0x03
@@ -0,0 +1,192 @@
+#pragma once
+//
+//    FILE: CrcPolicy.h
+// PURPOSE: selectable CRC implementation policies with footprint reporting
+//
+//  A policy picks how the register runs over the data:
+//
+//    CrcBitwisePolicy           eight conditional shifts per byte, no table
+//    CrcNibblePolicy            two lookups per byte, 16 entry table
+//    CrcBytePolicy              one lookup per byte, 256 entry table
+//    CrcSlicingPolicy<slices>   slices lookups per slices bytes (CRC32, CRC64)
+//    CrcHardwarePolicy          PCLMULQDQ folding (CRC16, CRC32, CRC64),
+//                               portable tables without it
+//
+//  CrcPolicyTraits<Policy, T, width, polynome, reflected> is the common
+//  trait: update() runs the register, flashBytes is the table size (in
+//  PROGMEM on AVR, const data elsewhere), ramBytes the register size, and
+//  cyclesPerByte() measures update() on the running board:
+//
+//    typedef CRC_PRESET_POLICY(16, CRC16_MODBUS, CrcNibblePolicy) Modbus;
+//    Serial.println(Modbus::Traits::flashBytes);
+//    Serial.println(Modbus::Traits::cyclesPerByte(buffer, sizeof(buffer)));
+
+
+#include "CrcDefines.h"
+#include "CrcTable.h"
+#include "CrcSlicing.h"
+#include "CrcClmul.h"
+
+#if !defined(ARDUINO) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#elif !defined(ARDUINO)
+#include <chrono>
+#endif
+
+
+struct CrcBitwisePolicy {};
+struct CrcNibblePolicy {};
+struct CrcBytePolicy {};
+template <uint8_t slices = 8> struct CrcSlicingPolicy {};
+struct CrcHardwarePolicy {};
+
+
+//  policy of calcCRC8() .. calcCRC64() for their default presets, set per
+//  board with -DCRC_DEFAULT_POLICY=CrcNibblePolicy or CrcBitwisePolicy
+//  to keep the 256 entry tables out of flash
+#ifndef CRC_DEFAULT_POLICY
+#define CRC_DEFAULT_POLICY CrcBytePolicy
+#endif
+
+
+namespace crc_detail
+{
+//  cycle counter for cyclesPerByte(), wraps around
+inline uint32_t cycles()
+{
+#if defined(ARDUINO)
+  return micros() * (F_CPU / 1000000UL);
+#elif defined(__x86_64__) || defined(__i386__)
+  return (uint32_t)__rdtsc();
+#else
+  //  no cycle counter, nanoseconds instead
+  return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+           std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+//  cyclesPerByte() shared by all policies
+template <typename Traits, typename T>
+struct PolicyMeasure
+{
+  //  Average over rounds runs of update() on array, which should be
+  //  long enough for the clock resolution (4 us = 64 cycles on an Uno).
+  static float cyclesPerByte(const uint8_t *array, crc_size_t length, uint16_t rounds = 16)
+  {
+    volatile T sink = 0;
+    uint32_t start = cycles();
+    for (uint16_t r = 0; r < rounds; r++)
+    {
+      sink = Traits::update(sink, array, length);
+    }
+    uint32_t elapsed = cycles() - start;
+    return (float)elapsed / ((float)length * rounds);
+  }
+};
+}  // namespace crc_detail
+
+
+//  Runs the register crc over array bit by bit and returns the new
+//  register, which is reflected when reflected is set.
+template <typename T, uint8_t width, T polynome, bool reflected>
+T crcBitwiseUpdate(T crc, const uint8_t *array, crc_size_t length)
+{
+  const T topBit = (T)((T)1 << (width - 1));
+  while (length--)
+  {
+    if (reflected)
+    {
+      crc ^= *array++;
+      for (uint8_t i = 8; i; i--)
+      {
+        crc = (crc & 1) ? (T)((crc >> 1) ^ crc_detail::reflect<T>(polynome, width)) : (T)(crc >> 1);
+      }
+    }
+    else
+    {
+      crc ^= (T)((T)*array++ << (width - 8));
+      for (uint8_t i = 8; i; i--)
+      {
+        crc = (crc & topBit) ? (T)((T)(crc << 1) ^ polynome) : (T)(crc << 1);
+      }
+      crc &= crc_detail::mask<T>(width);
+    }
+  }
+  return crc;
+}
+
+
+template <typename Policy, typename T, uint8_t width, T polynome, bool reflected>
+struct CrcPolicyTraits;
+
+template <typename T, uint8_t width, T polynome, bool reflected>
+struct CrcPolicyTraits<CrcBitwisePolicy, T, width, polynome, reflected> :
+  crc_detail::PolicyMeasure<CrcPolicyTraits<CrcBitwisePolicy, T, width, polynome, reflected>, T>
+{
+  static const size_t flashBytes = 0;
+  static const size_t ramBytes = sizeof(T);
+
+  static T update(T crc, const uint8_t *array, crc_size_t length)
+  {
+    return crcBitwiseUpdate<T, width, polynome, reflected>(crc, array, length);
+  }
+};
+
+template <typename T, uint8_t width, T polynome, bool reflected>
+struct CrcPolicyTraits<CrcNibblePolicy, T, width, polynome, reflected> :
+  crc_detail::PolicyMeasure<CrcPolicyTraits<CrcNibblePolicy, T, width, polynome, reflected>, T>
+{
+  static const size_t flashBytes = 16 * sizeof(T);
+  static const size_t ramBytes = sizeof(T);
+
+  static T update(T crc, const uint8_t *array, crc_size_t length)
+  {
+    return crcNibbleTableUpdate<T, width, polynome, reflected>(crc, array, length);
+  }
+};
+
+template <typename T, uint8_t width, T polynome, bool reflected>
+struct CrcPolicyTraits<CrcBytePolicy, T, width, polynome, reflected> :
+  crc_detail::PolicyMeasure<CrcPolicyTraits<CrcBytePolicy, T, width, polynome, reflected>, T>
+{
+  static const size_t flashBytes = 256 * sizeof(T);
+  static const size_t ramBytes = sizeof(T);
+
+  static T update(T crc, const uint8_t *array, crc_size_t length)
+  {
+    return crcByteTableUpdate<T, width, polynome, reflected>(crc, array, length);
+  }
+};
+
+template <uint8_t slices, typename T, uint8_t width, T polynome, bool reflected>
+struct CrcPolicyTraits<CrcSlicingPolicy<slices>, T, width, polynome, reflected> :
+  crc_detail::PolicyMeasure<CrcPolicyTraits<CrcSlicingPolicy<slices>, T, width, polynome, reflected>, T>
+{
+  static const size_t flashBytes = slices * 256 * sizeof(T);
+  static const size_t ramBytes = sizeof(T);
+
+  static T update(T crc, const uint8_t *array, crc_size_t length)
+  {
+    return crcSlicingUpdate<T, width, polynome, reflected, slices>(crc, array, length);
+  }
+};
+
+template <typename T, uint8_t width, T polynome, bool reflected>
+struct CrcPolicyTraits<CrcHardwarePolicy, T, width, polynome, reflected> :
+  crc_detail::PolicyMeasure<CrcPolicyTraits<CrcHardwarePolicy, T, width, polynome, reflected>, T>
+{
+  //  the byte table of the folding tail and short inputs, plus the
+  //  slicing-by-8 tables of the portable CRC32 / CRC64 kernel; the
+  //  portable CRC16 kernel shares the byte table, see CrcClmul.h
+  static const size_t flashBytes = (width == 16 ? 256 : (1 + 8) * 256) * sizeof(T);
+  static const size_t ramBytes = sizeof(T);
+
+  static T update(T crc, const uint8_t *array, crc_size_t length)
+  {
+    return crcClmulUpdate<T, width, polynome, reflected>(crc, array, length);
+  }
+};
+
+
+//  -- END OF FILE --
+
@@ -0,0 +1,208 @@
+//
+//    FILE: CrcRegistry.cpp
+// PURPOSE: run time lookup of the CrcParameters.h presets by name
+//
+//  One table routine serves all widths: a reflected register keeps its
+//  width bits at the bottom and shifts right, a normal register keeps
+//  them at the top of a uint64_t and shifts left, so both index the
+//  table with one byte and need no masking per step.
+
+
+#include "CrcRegistry.h"
+#include "CrcCombine.h"
+#include "CrcTable.h"
+
+#include <strings.h>
+
+
+namespace
+{
+#define PRESET(width, name, check) \
+  { #name, width, name##_POLYNOME, name##_INITIAL, name##_XOR_OUT, name##_REV_IN, name##_REV_OUT, check },
+CrcPreset presets[] =
+{
+  CRC_REGISTRY_PRESETS
+};
+#undef PRESET
+
+const size_t presetCount = sizeof(presets) / sizeof(presets[0]);
+
+
+//  normal registers are aligned to the top
+uint8_t topShift(const CrcPreset &preset)
+{
+  return 64 - preset.width;
+}
+
+uint64_t startRegister(const CrcPreset &preset)
+{
+  if (preset.reverseIn) return crc_detail::reverseBits(preset.initial, preset.width);
+  return preset.initial << topShift(preset);
+}
+
+void buildTable(const CrcPreset &preset, uint64_t *table)
+{
+  if (preset.reverseIn)
+  {
+    const uint64_t polynome = crc_detail::reverseBits(preset.polynome, preset.width);
+    for (uint16_t i = 0; i < 256; i++)
+    {
+      uint64_t crc = i;
+      for (uint8_t bit = 0; bit < 8; bit++)
+      {
+        crc = (crc & 1) ? (crc >> 1) ^ polynome : crc >> 1;
+      }
+      table[i] = crc;
+    }
+  }
+  else
+  {
+    const uint64_t polynome = preset.polynome << topShift(preset);
+    for (uint16_t i = 0; i < 256; i++)
+    {
+      uint64_t crc = (uint64_t)i << 56;
+      for (uint8_t bit = 0; bit < 8; bit++)
+      {
+        crc = (crc >> 63) ? (crc << 1) ^ polynome : crc << 1;
+      }
+      table[i] = crc;
+    }
+  }
+}
+}  // namespace
+
+
+const uint64_t *CrcPreset::table() const
+{
+  std::call_once(_tableOnce, [this]
+  {
+    _table.reset(new uint64_t[256]);
+    buildTable(*this, _table.get());
+  });
+  return _table.get();
+}
+
+
+const CrcPreset *crcFindPreset(const char *name)
+{
+  for (const CrcPreset &preset : presets)
+  {
+    if (strcasecmp(preset.name, name) == 0) return &preset;
+  }
+  return nullptr;
+}
+
+
+size_t crcPresetCount()
+{
+  return presetCount;
+}
+
+
+const CrcPreset &crcPresetAt(size_t index)
+{
+  return presets[index];
+}
+
+
+////////////////////////////////////////////////////////////////
+//
+//  CrcRuntime
+//
+CrcRuntime::CrcRuntime(const CrcPreset &preset)
+{
+  _preset = &preset;
+  _table = preset.table();
+  restart();
+}
+
+
+void CrcRuntime::restart()
+{
+  _crc = startRegister(*_preset);
+  _count = 0;
+}
+
+
+uint64_t CrcRuntime::calc() const
+{
+  const CrcPreset &preset = *_preset;
+  uint64_t rv = preset.reverseIn ? _crc : _crc >> topShift(preset);
+  //  a reflected register already is the reversed output
+  if (preset.reverseOut != preset.reverseIn) rv = crc_detail::reverseBits(rv, preset.width);
+  return (rv ^ preset.xorOut) & crc_detail::mask<uint64_t>(preset.width);
+}
+
+
+crc_size_t CrcRuntime::count() const
+{
+  return _count;
+}
+
+
+void CrcRuntime::add(uint8_t value)
+{
+  add(&value, 1);
+}
+
+
+void CrcRuntime::add(const uint8_t *array, crc_size_t length)
+{
+  _count += length;
+  uint64_t crc = _crc;
+  if (_preset->reverseIn)
+  {
+    while (length--) crc = (crc >> 8) ^ _table[(uint8_t)crc ^ *array++];
+  }
+  else
+  {
+    while (length--) crc = (crc << 8) ^ _table[(uint8_t)(crc >> 56) ^ *array++];
+  }
+  _crc = crc;
+}
+
+
+void CrcRuntime::add(const uint8_t *array, crc_size_t length, crc_size_t yieldPeriod)
+{
+  if (yieldPeriod == CRC_YIELD_DISABLED)
+  {
+    add(array, length);
+    return;
+  }
+  while (length > 0)
+  {
+    crc_size_t part = length < yieldPeriod ? length : yieldPeriod;
+    add(array, part);
+    array += part;
+    length -= part;
+    if (part == yieldPeriod) yield();
+  }
+}
+
+
+void CrcRuntime::add(const CrcSegment *segments, crc_size_t count)
+{
+  while (count--)
+  {
+    add(segments->data, segments->length);
+    segments++;
+  }
+}
+
+
+uint64_t CrcRuntime::compute(const CrcPreset &preset, const uint8_t *array, crc_size_t length)
+{
+  CrcRuntime crc(preset);
+  crc.add(array, length);
+  return crc.calc();
+}
+
+
+uint64_t CrcRuntime::combine(const CrcPreset &preset, uint64_t crcA, uint64_t crcB, crc_size_t lengthB)
+{
+  return crc_detail::combine<uint64_t>(crcA, crcB, lengthB, preset.polynome, preset.initial,
+                                       preset.xorOut, preset.reverseOut, preset.width);
+}
+
+
+//  -- END OF FILE --
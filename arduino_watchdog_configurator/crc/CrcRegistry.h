@@ -0,0 +1,144 @@
+#pragma once
+//
+//    FILE: CrcRegistry.h
+// PURPOSE: run time lookup of the CrcParameters.h presets by name
+//
+//  Host side registry, for tools and gateways that pick the preset per
+//  file or per connection instead of at compile time:
+//
+//    const CrcPreset *preset = crcFindPreset("CRC16_MODBUS");
+//    CrcRuntime crc(*preset);
+//    crc.add(array, length);
+//    uint64_t value = crc.calc();
+//
+//  Each preset has one 256 entry lookup table, built on first use and
+//  shared by every CrcRuntime of that preset, from any thread. A
+//  CrcRuntime itself is a preset pointer, a table pointer and the
+//  register, so per connection state costs no table.
+
+
+#include "CrcParameters.h"
+#include "CrcDefines.h"
+#include "CrcSegment.h"
+
+#include <memory>
+#include <mutex>
+
+
+//  X macro over the complete presets, PRESET(width, name, check value),
+//  the check value is the CRC of the 9 bytes "123456789"
+#define CRC_REGISTRY_PRESETS \
+  PRESET(8, CRC8, 0xF4) \
+  PRESET(8, CRC8_SAEJ1850, 0x4B) \
+  PRESET(8, CRC8_SAEJ1850_ZERO, 0x37) \
+  PRESET(8, CRC8_8H2F, 0xDF) \
+  PRESET(8, CRC8_WCDMA, 0xDA) \
+  PRESET(8, CRC8_DARC, 0x15) \
+  PRESET(8, CRC8_DVB_S2, 0xBC) \
+  PRESET(8, CRC8_EBU, 0x97) \
+  PRESET(8, CRC8_ICODE, 0x7E) \
+  PRESET(8, CRC8_ITU, 0xA1) \
+  PRESET(8, CRC8_DALLAS_MAXIM, 0xA1) \
+  PRESET(8, CRC8_ROHC, 0xD0) \
+  PRESET(12, CRC12, 0xEFB) \
+  PRESET(16, CRC16, 0xA829) \
+  PRESET(16, CRC16_CCITT, 0x31C3) \
+  PRESET(16, CRC16_CCITT_FALSE, 0x29B1) \
+  PRESET(16, CRC16_AUG_CCITT, 0xE5CC) \
+  PRESET(16, CRC16_ARC, 0xBB3D) \
+  PRESET(16, CRC16_BUYPASS, 0xFEE8) \
+  PRESET(16, CRC16_CDMA2000, 0x4C06) \
+  PRESET(16, CRC16_DDS_110, 0x9ECF) \
+  PRESET(16, CRC16_DECT_R, 0x007E) \
+  PRESET(16, CRC16_DECT_X, 0x007F) \
+  PRESET(16, CRC16_DNP, 0xEA82) \
+  PRESET(16, CRC16_GENIBUS, 0xD64E) \
+  PRESET(16, CRC16_MAXIM, 0x44C2) \
+  PRESET(16, CRC16_MCRF4XX, 0x6F91) \
+  PRESET(16, CRC16_RIELLO, 0x63D0) \
+  PRESET(16, CRC16_T10_DIF, 0xD0DB) \
+  PRESET(16, CRC16_TELEDISK, 0x0FB3) \
+  PRESET(16, CRC16_TMS37157, 0x26B1) \
+  PRESET(16, CRC16_USB, 0xB4C8) \
+  PRESET(16, CRC16_A, 0xBF05) \
+  PRESET(16, CRC16_KERMIT, 0x2189) \
+  PRESET(16, CRC16_MODBUS, 0x4B37) \
+  PRESET(16, CRC16_X_25, 0x906E) \
+  PRESET(16, CRC16_XMODEM, 0x31C3) \
+  PRESET(32, CRC32, 0xCBF43926) \
+  PRESET(32, CRC32_ISO3309, 0xFC891918) \
+  PRESET(32, CRC32_CASTAGNOLI, 0xE3069283) \
+  PRESET(32, CRC32_D, 0x87315576) \
+  PRESET(32, CRC32_Q, 0x3010BF7F) \
+  PRESET(64, CRC64_ECMA64, 0x6C40DF5F0B497347) \
+  PRESET(64, CRC64, 0x6C40DF5F0B497347) \
+  PRESET(64, CRC64_ISO64, 0xB90956C775A41001)
+
+
+struct CrcPreset
+{
+  constexpr CrcPreset(const char *name, uint8_t width, uint64_t polynome,
+                      uint64_t initial, uint64_t xorOut, bool reverseIn,
+                      bool reverseOut, uint64_t check) :
+    name(name), width(width), polynome(polynome), initial(initial), xorOut(xorOut),
+    reverseIn(reverseIn), reverseOut(reverseOut), check(check),
+    _tableOnce(), _table()
+  {}
+
+  const char *name;
+  uint8_t width;
+  uint64_t polynome;
+  uint64_t initial;
+  uint64_t xorOut;
+  bool reverseIn;
+  bool reverseOut;
+  uint64_t check;
+
+  //  The lookup table in the register domain of CrcRuntime, built on the
+  //  first call, thread safe.
+  const uint64_t *table() const;
+
+  mutable std::once_flag _tableOnce;
+  mutable std::unique_ptr<uint64_t[]> _table;
+};
+
+
+//  nullptr for an unknown name, case is ignored
+const CrcPreset *crcFindPreset(const char *name);
+
+//  all presets, in CrcParameters.h order
+size_t crcPresetCount();
+const CrcPreset &crcPresetAt(size_t index);
+
+
+class CrcRuntime
+{
+public:
+  explicit CrcRuntime(const CrcPreset &preset);
+
+  void restart();
+  uint64_t calc() const;
+  crc_size_t count() const;
+  void add(uint8_t value);
+  void add(const uint8_t *array, crc_size_t length);
+  void add(const uint8_t *array, crc_size_t length, crc_size_t yieldPeriod);
+  //  count segments in message order, see CrcSegment.h
+  void add(const CrcSegment *segments, crc_size_t count);
+
+  const CrcPreset &getPreset() const { return *_preset; }
+
+  static uint64_t compute(const CrcPreset &preset, const uint8_t *array, crc_size_t length);
+  //  CRC of A followed by B from the CRCs of A and B, see CrcCombine.h
+  static uint64_t combine(const CrcPreset &preset, uint64_t crcA, uint64_t crcB, crc_size_t lengthB);
+
+private:
+  const CrcPreset *_preset;
+  const uint64_t *_table;
+  //  reflected register when reverseIn is set, otherwise the width
+  //  bits are kept at the top of the 64 bits
+  uint64_t _crc;
+  crc_size_t _count;
+};
+
+
+//  -- END OF FILE --
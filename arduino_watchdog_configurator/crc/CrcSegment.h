@@ -0,0 +1,48 @@
+#pragma once
+//
+//    FILE: CrcSegment.h
+// PURPOSE: scatter-gather segments for checksumming non contiguous data
+//
+//  A message whose parts live in different places is checksummed in
+//  place by listing the parts in message order:
+//
+//    CrcSegment parts[] = { { header, 2 }, { &ack, 1 }, { status, 3 } };
+//    crc.add(parts, 3);
+//
+//  crcRingSegments() describes a region of a ring buffer, which may
+//  wrap around the end of the buffer, as one or two segments.
+
+
+#include "CrcDefines.h"
+
+
+struct CrcSegment
+{
+  const uint8_t *data;
+  crc_size_t length;
+};
+
+
+//  length bytes from index start of a ring buffer of capacity bytes,
+//  returns the number of segments (1 or 2) written to segments.
+inline uint8_t crcRingSegments(const uint8_t *buffer, crc_size_t capacity,
+                               crc_size_t start, crc_size_t length,
+                               CrcSegment segments[2])
+{
+  const crc_size_t first = capacity - start;
+  if (length <= first)
+  {
+    segments[0].data = buffer + start;
+    segments[0].length = length;
+    return 1;
+  }
+  segments[0].data = buffer + start;
+  segments[0].length = first;
+  segments[1].data = buffer;
+  segments[1].length = length - first;
+  return 2;
+}
+
+
+//  -- END OF FILE --
+
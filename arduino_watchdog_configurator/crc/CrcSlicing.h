@@ -0,0 +1,109 @@
+#pragma once
+//
+//    FILE: CrcSlicing.h
+// PURPOSE: slicing-by-N kernel for CRC32 and CRC64
+//
+//  Consumes slices (4, 8 or 16) bytes per step with slices independent
+//  table lookups, which removes the byte to byte dependency of the byte
+//  table engine. Meant for host side bulk checksumming, the tables take
+//  slices * 256 * sizeof(T) bytes (8 KB for slicing-by-8 CRC32).
+
+
+#include "CrcDefines.h"
+#include "CrcTable.h"
+
+#include <string.h>
+
+
+namespace crc_detail
+{
+//  Reads 4 bytes as one word, first byte in the low bits for reflected
+//  registers and in the high bits for normal ones.
+template <bool reflected>
+inline uint32_t sliceWord(const uint8_t *array)
+{
+  uint32_t word;
+  memcpy(&word, array, sizeof(word));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+  if (reflected) word = __builtin_bswap32(word);
+#else
+  if (!reflected) word = __builtin_bswap32(word);
+#endif
+  return word;
+}
+
+//  Folds the 4 bytes of word, which are bytes first .. first + 3 of the slice.
+template <typename Tables, bool reflected, uint8_t slices>
+inline typename Tables::Type sliceLookup(uint32_t word, uint8_t first)
+{
+  const uint8_t last = slices - 1 - first;
+  if (reflected)
+  {
+    return Tables::read(last,     (uint8_t)word)
+         ^ Tables::read(last - 1, (uint8_t)(word >> 8))
+         ^ Tables::read(last - 2, (uint8_t)(word >> 16))
+         ^ Tables::read(last - 3, (uint8_t)(word >> 24));
+  }
+  return Tables::read(last,     (uint8_t)(word >> 24))
+       ^ Tables::read(last - 1, (uint8_t)(word >> 16))
+       ^ Tables::read(last - 2, (uint8_t)(word >> 8))
+       ^ Tables::read(last - 3, (uint8_t)word);
+}
+}  // namespace crc_detail
+
+
+//  Runs the register crc over array and returns the new register.
+//  The register is reflected (right shifting) when reflected is set.
+template <typename T, uint8_t width, T polynome, bool reflected, uint8_t slices>
+T crcSlicingUpdate(T crc, const uint8_t *array, crc_size_t length)
+{
+  static_assert(width == 32 || width == 64, "slicing is implemented for CRC32 and CRC64");
+  static_assert(width == 8 * sizeof(T), "slicing needs a full width register");
+  static_assert(slices == 4 || slices == 8 || slices == 16, "slices must be 4, 8 or 16");
+
+  typedef CrcSliceTables<T, width, polynome, reflected, slices> Tables;
+  //  the register covers the first one (CRC32) or two (CRC64) words
+  const uint8_t registerWords = width / 32;
+
+  while (length >= slices)
+  {
+    T next = 0;
+    for (uint8_t w = 0; w < slices / 4; w++)
+    {
+      uint32_t word = crc_detail::sliceWord<reflected>(array + 4 * w);
+      if (w < registerWords)
+      {
+        //  register word w, counted from the end that is shifted out first
+        const uint8_t shift = reflected ? 32 * w : width - 32 - 32 * w;
+        word ^= (uint32_t)(crc >> (shift % width));
+      }
+      next ^= crc_detail::sliceLookup<Tables, reflected, slices>(word, 4 * w);
+    }
+    if (slices < registerWords * 4)
+    {
+      //  slicing-by-4 on CRC64 keeps half of the register
+      next ^= reflected ? (T)(crc >> (32 % width)) : (T)(crc << (32 % width));
+    }
+    crc = next;
+    array += slices;
+    length -= slices;
+  }
+
+  //  tail, slice table 0 is the plain byte table
+  while (length--)
+  {
+    if (reflected)
+    {
+      crc = (crc >> 8) ^ Tables::read(0, (uint8_t)crc ^ *array++);
+    }
+    else
+    {
+      crc = (crc << 8) ^ Tables::read(0, (uint8_t)(crc >> (width - 8)) ^ *array++);
+    }
+  }
+  return crc;
+}
+
+
+//  -- END OF FILE --
+
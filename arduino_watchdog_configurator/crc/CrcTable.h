@@ -0,0 +1,292 @@
+#pragma once
+//
+//    FILE: CrcTable.h
+// PURPOSE: compile time generated lookup tables for table driven CRC engines
+//
+//  Tables are generated by the compiler from the polynome, so no table
+//  has to be pasted into the source and every preset in CrcParameters.h
+//  gets its own table just by naming it as template argument.
+//  On boards with PROGMEM the tables are stored in flash.
+
+
+#include "CrcDefines.h"
+
+
+// Conditionally use pgm memory if it is available.
+#if defined(PROGMEM)
+    #define FLASH_PROGMEM PROGMEM
+    #define FLASH_READ_BYTE(x) (pgm_read_byte_near(x))
+    #define FLASH_READ_WORD(x) (pgm_read_word_near(x))
+    #define FLASH_READ_DWORD(x) (pgm_read_dword_near(x))
+#else
+    #define FLASH_PROGMEM
+    #define FLASH_READ_BYTE(x) (*(const uint8_t*)(x))
+    #define FLASH_READ_WORD(x) (*(const uint16_t*)(x))
+    #define FLASH_READ_DWORD(x) (*(const uint32_t*)(x))
+#endif
+
+
+inline uint8_t crcFlashRead(const uint8_t *address)
+{
+  return FLASH_READ_BYTE(address);
+}
+
+inline uint16_t crcFlashRead(const uint16_t *address)
+{
+  return FLASH_READ_WORD(address);
+}
+
+inline uint32_t crcFlashRead(const uint32_t *address)
+{
+  return FLASH_READ_DWORD(address);
+}
+
+inline uint64_t crcFlashRead(const uint64_t *address)
+{
+#if defined(PROGMEM)
+  //  AVR is little endian, read as two dwords
+  const uint32_t *half = (const uint32_t *)address;
+  return ((uint64_t)FLASH_READ_DWORD(half + 1) << 32) | FLASH_READ_DWORD(half);
+#else
+  return *address;
+#endif
+}
+
+
+namespace crc_detail
+{
+//  C++11 constexpr functions are a single return statement,
+//  so the bit loops below are written as recursion.
+
+template <typename T>
+constexpr T mask(uint8_t width)
+{
+  return width >= 8 * sizeof(T) ? (T)~(T)0 : (T)(((T)1 << width) - 1);
+}
+
+template <typename T>
+constexpr T reflect(T value, uint8_t width)
+{
+  return width == 0 ? (T)0
+       : (T)(((T)(value & 1) << (width - 1)) | reflect<T>((T)(value >> 1), width - 1));
+}
+
+//  MSB first division, shifts the register left.
+template <typename T>
+constexpr T normalBits(T crc, T polynome, T topBit, uint8_t bits)
+{
+  return bits == 0 ? crc
+       : normalBits<T>((crc & topBit) ? (T)((T)(crc << 1) ^ polynome) : (T)(crc << 1),
+                       polynome, topBit, bits - 1);
+}
+
+//  LSB first division with the reflected polynome, shifts the register right.
+template <typename T>
+constexpr T reflectedBits(T crc, T reflectedPolynome, uint8_t bits)
+{
+  return bits == 0 ? crc
+       : reflectedBits<T>((crc & 1) ? (T)((crc >> 1) ^ reflectedPolynome) : (T)(crc >> 1),
+                          reflectedPolynome, bits - 1);
+}
+
+//  Table entry for one index byte.
+//  A normal table is indexed by the top byte of the register,
+//  a reflected table by the bottom byte of the reflected register.
+template <typename T, uint8_t width, T polynome, bool reflected>
+constexpr T byteTableEntry(uint8_t index)
+{
+  return reflected
+       ? reflectedBits<T>(index, reflect<T>(polynome, width), 8)
+       : (T)(normalBits<T>((T)((T)index << (width - 8)), polynome,
+                           (T)((T)1 << (width - 1)), 8) & mask<T>(width));
+}
+
+//  Table entry for one index nibble, the 16 entry variant of byteTableEntry.
+template <typename T, uint8_t width, T polynome, bool reflected>
+constexpr T nibbleTableEntry(uint8_t index)
+{
+  return reflected
+       ? reflectedBits<T>(index, reflect<T>(polynome, width), 4)
+       : (T)(normalBits<T>((T)((T)index << (width - 4)), polynome,
+                           (T)((T)1 << (width - 1)), 4) & mask<T>(width));
+}
+
+//  Entry of slice table k: the CRC of the index byte followed by k zero bytes.
+template <typename T, uint8_t width, T polynome, bool reflected>
+constexpr T sliceTableAdvance(T entry)
+{
+  return reflected
+       ? (T)((entry >> 8) ^ byteTableEntry<T, width, polynome, reflected>((uint8_t)entry))
+       : (T)(((T)(entry << 8) ^ byteTableEntry<T, width, polynome, reflected>((uint8_t)(entry >> (width - 8))))
+             & mask<T>(width));
+}
+
+template <typename T, uint8_t width, T polynome, bool reflected>
+constexpr T sliceTableEntry(uint8_t slice, uint8_t index)
+{
+  return slice == 0
+       ? byteTableEntry<T, width, polynome, reflected>(index)
+       : sliceTableAdvance<T, width, polynome, reflected>(
+           sliceTableEntry<T, width, polynome, reflected>(slice - 1, index));
+}
+
+template <uint16_t... I>
+struct IndexList {};
+
+template <typename A, typename B>
+struct ConcatIndexList;
+
+template <uint16_t... I, uint16_t... J>
+struct ConcatIndexList<IndexList<I...>, IndexList<J...> >
+{
+  typedef IndexList<I..., (uint16_t)(sizeof...(I) + J)...> type;
+};
+
+//  0 .. N-1, built by halving to keep the template depth logarithmic
+template <uint16_t N>
+struct MakeIndexList : ConcatIndexList<typename MakeIndexList<N / 2>::type,
+                                       typename MakeIndexList<N - N / 2>::type> {};
+
+template <>
+struct MakeIndexList<0>
+{
+  typedef IndexList<> type;
+};
+
+template <>
+struct MakeIndexList<1>
+{
+  typedef IndexList<0> type;
+};
+}  // namespace crc_detail
+
+
+//  256 entry table, one lookup per byte.
+//  reflected == true gives the table for reverseIn presets, used with a
+//  reflected (right shifting) register so no per byte reversal is needed.
+template <typename T, uint8_t width, T polynome, bool reflected,
+          typename = typename crc_detail::MakeIndexList<256>::type>
+struct CrcByteTable;
+
+template <typename T, uint8_t width, T polynome, bool reflected, uint16_t... I>
+struct CrcByteTable<T, width, polynome, reflected, crc_detail::IndexList<I...> >
+{
+  static_assert(width >= 8 && width <= 8 * sizeof(T), "CRC width does not fit the table type");
+
+  static const T values[sizeof...(I)];
+
+  static T read(uint8_t index)
+  {
+    return crcFlashRead(values + index);
+  }
+};
+
+template <typename T, uint8_t width, T polynome, bool reflected, uint16_t... I>
+const T CrcByteTable<T, width, polynome, reflected, crc_detail::IndexList<I...> >::values[sizeof...(I)] FLASH_PROGMEM =
+{
+  crc_detail::byteTableEntry<T, width, polynome, reflected>(I)...
+};
+
+
+//  Runs the register crc over array with one table lookup per byte and
+//  returns the new register, which is reflected when reflected is set.
+template <typename T, uint8_t width, T polynome, bool reflected>
+T crcByteTableUpdate(T crc, const uint8_t *array, crc_size_t length)
+{
+  typedef CrcByteTable<T, width, polynome, reflected> Table;
+  while (length--)
+  {
+    if (reflected)
+    {
+      crc = (crc >> 8) ^ Table::read((uint8_t)crc ^ *array++);
+    }
+    else
+    {
+      crc = (T)((T)(crc << 8) ^ Table::read((uint8_t)(crc >> (width - 8)) ^ *array++)) & crc_detail::mask<T>(width);
+    }
+  }
+  return crc;
+}
+
+
+//  16 entry table, two lookups per byte.
+//  Trades speed for size: 16 * sizeof(T) bytes instead of 256 * sizeof(T).
+template <typename T, uint8_t width, T polynome, bool reflected,
+          typename = typename crc_detail::MakeIndexList<16>::type>
+struct CrcNibbleTable;
+
+template <typename T, uint8_t width, T polynome, bool reflected, uint16_t... I>
+struct CrcNibbleTable<T, width, polynome, reflected, crc_detail::IndexList<I...> >
+{
+  static_assert(width >= 8 && width <= 8 * sizeof(T), "CRC width does not fit the table type");
+
+  static const T values[sizeof...(I)];
+
+  static T read(uint8_t index)
+  {
+    return crcFlashRead(values + index);
+  }
+};
+
+template <typename T, uint8_t width, T polynome, bool reflected, uint16_t... I>
+const T CrcNibbleTable<T, width, polynome, reflected, crc_detail::IndexList<I...> >::values[sizeof...(I)] FLASH_PROGMEM =
+{
+  crc_detail::nibbleTableEntry<T, width, polynome, reflected>(I)...
+};
+
+
+//  Runs the register crc over array with one table lookup per nibble and
+//  returns the new register, which is reflected when reflected is set.
+//  A reflected register takes the low nibble first.
+template <typename T, uint8_t width, T polynome, bool reflected>
+T crcNibbleTableUpdate(T crc, const uint8_t *array, crc_size_t length)
+{
+  typedef CrcNibbleTable<T, width, polynome, reflected> Table;
+  while (length--)
+  {
+    uint8_t value = *array++;
+    if (reflected)
+    {
+      crc = (crc >> 4) ^ Table::read((uint8_t)(crc ^ value) & 0x0F);
+      crc = (crc >> 4) ^ Table::read((uint8_t)(crc ^ (value >> 4)) & 0x0F);
+    }
+    else
+    {
+      crc = (T)((T)(crc << 4) ^ Table::read((uint8_t)((crc >> (width - 4)) ^ (value >> 4)) & 0x0F)) & crc_detail::mask<T>(width);
+      crc = (T)((T)(crc << 4) ^ Table::read((uint8_t)((crc >> (width - 4)) ^ value) & 0x0F)) & crc_detail::mask<T>(width);
+    }
+  }
+  return crc;
+}
+
+
+//  slices tables of 256 entries, stored flat, table k at values[k * 256].
+//  Used by the slicing-by-N engines which consume N bytes per step.
+template <typename T, uint8_t width, T polynome, bool reflected, uint8_t slices,
+          typename = typename crc_detail::MakeIndexList<slices * 256>::type>
+struct CrcSliceTables;
+
+template <typename T, uint8_t width, T polynome, bool reflected, uint8_t slices, uint16_t... I>
+struct CrcSliceTables<T, width, polynome, reflected, slices, crc_detail::IndexList<I...> >
+{
+  static_assert(width >= 8 && width <= 8 * sizeof(T), "CRC width does not fit the table type");
+
+  typedef T Type;
+
+  static const T values[sizeof...(I)];
+
+  static T read(uint8_t slice, uint8_t index)
+  {
+    return crcFlashRead(values + slice * 256 + index);
+  }
+};
+
+template <typename T, uint8_t width, T polynome, bool reflected, uint8_t slices, uint16_t... I>
+const T CrcSliceTables<T, width, polynome, reflected, slices, crc_detail::IndexList<I...> >::values[sizeof...(I)] FLASH_PROGMEM =
+{
+  crc_detail::sliceTableEntry<T, width, polynome, reflected>(I / 256, I % 256)...
+};
+
+
+//  -- END OF FILE --
+
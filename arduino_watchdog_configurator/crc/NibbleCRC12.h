@@ -0,0 +1,27 @@
+#pragma once
+//
+//    FILE: NibbleCRC12.h
+// PURPOSE: Arduino class for nibble table driven CRC12
+//
+//  Two lookups in a 16 entry table per byte instead of eight conditional
+//  shifts. Polynome and reverseIn select the table at compile time,
+//  e.g. for CRC12:
+//
+//    NibbleCRC12<CRC12_POLYNOME, CRC12_REV_IN> crc(
+//      CRC12_INITIAL, CRC12_XOR_OUT, CRC12_REV_OUT);
+//
+//  The table costs 32 bytes of flash per polynome / reverseIn pair,
+//  against 512 bytes for a 256 entry table.
+//  Results are identical to CRC12 with the same parameters.
+
+
+#include "CrcParameters.h"
+#include "CrcClass.h"
+
+
+template <uint16_t polynome = CRC12_POLYNOME, bool reverseIn = CRC12_REV_IN>
+using NibbleCRC12 = CrcClass<12, polynome, reverseIn, CrcNibblePolicy,
+                             CRC12_INITIAL, CRC12_XOR_OUT, CRC12_REV_OUT>;
+
+
+//  -- END OF FILE --
@@ -0,0 +1,27 @@
+#pragma once
+//
+//    FILE: NibbleCRC16.h
+// PURPOSE: Arduino class for nibble table driven CRC16
+//
+//  Two lookups in a 16 entry table per byte instead of eight conditional
+//  shifts. Polynome and reverseIn select the table at compile time,
+//  e.g. for CRC16_MODBUS:
+//
+//    NibbleCRC16<CRC16_MODBUS_POLYNOME, CRC16_MODBUS_REV_IN> crc(
+//      CRC16_MODBUS_INITIAL, CRC16_MODBUS_XOR_OUT, CRC16_MODBUS_REV_OUT);
+//
+//  The table costs 32 bytes of flash per polynome / reverseIn pair,
+//  against 512 bytes for a 256 entry table.
+//  Results are identical to CRC16 with the same parameters.
+
+
+#include "CrcParameters.h"
+#include "CrcClass.h"
+
+
+template <uint16_t polynome = CRC16_POLYNOME, bool reverseIn = CRC16_REV_IN>
+using NibbleCRC16 = CrcClass<16, polynome, reverseIn, CrcNibblePolicy,
+                             CRC16_INITIAL, CRC16_XOR_OUT, CRC16_REV_OUT>;
+
+
+//  -- END OF FILE --
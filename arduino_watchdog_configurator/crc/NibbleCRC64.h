@@ -0,0 +1,27 @@
+#pragma once
+//
+//    FILE: NibbleCRC64.h
+// PURPOSE: Arduino class for nibble table driven CRC64
+//
+//  Two lookups in a 16 entry table per byte instead of eight conditional
+//  shifts. Polynome and reverseIn select the table at compile time,
+//  e.g. for CRC64_ISO64:
+//
+//    NibbleCRC64<CRC64_ISO64_POLYNOME, CRC64_ISO64_REV_IN> crc(
+//      CRC64_ISO64_INITIAL, CRC64_ISO64_XOR_OUT, CRC64_ISO64_REV_OUT);
+//
+//  The table costs 128 bytes of flash per polynome / reverseIn pair,
+//  against 2048 bytes for a 256 entry table.
+//  Results are identical to CRC64 with the same parameters.
+
+
+#include "CrcParameters.h"
+#include "CrcClass.h"
+
+
+template <uint64_t polynome = CRC64_POLYNOME, bool reverseIn = CRC64_REV_IN>
+using NibbleCRC64 = CrcClass<64, polynome, reverseIn, CrcNibblePolicy,
+                             CRC64_INITIAL, CRC64_XOR_OUT, CRC64_REV_OUT>;
+
+
+//  -- END OF FILE --
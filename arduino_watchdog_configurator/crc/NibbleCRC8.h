@@ -0,0 +1,27 @@
+#pragma once
+//
+//    FILE: NibbleCRC8.h
+// PURPOSE: Arduino class for nibble table driven CRC8
+//
+//  Two lookups in a 16 entry table per byte instead of eight conditional
+//  shifts. Polynome and reverseIn select the table at compile time,
+//  e.g. for CRC8_DALLAS_MAXIM:
+//
+//    NibbleCRC8<CRC8_DALLAS_MAXIM_POLYNOME, CRC8_DALLAS_MAXIM_REV_IN> crc(
+//      CRC8_DALLAS_MAXIM_INITIAL, CRC8_DALLAS_MAXIM_XOR_OUT, CRC8_DALLAS_MAXIM_REV_OUT);
+//
+//  The table costs 16 bytes of flash per polynome / reverseIn pair,
+//  against 256 bytes for a 256 entry table.
+//  Results are identical to CRC8 with the same parameters.
+
+
+#include "CrcParameters.h"
+#include "CrcClass.h"
+
+
+template <uint8_t polynome = CRC8_POLYNOME, bool reverseIn = CRC8_REV_IN>
+using NibbleCRC8 = CrcClass<8, polynome, reverseIn, CrcNibblePolicy,
+                            CRC8_INITIAL, CRC8_XOR_OUT, CRC8_REV_OUT>;
+
+
+//  -- END OF FILE --
@@ -0,0 +1,23 @@
+#pragma once
+//
+//    FILE: SlicingCRC32.h
+// PURPOSE: class for slicing-by-4/8/16 CRC32 (host side bulk checksumming)
+//
+//  Results are identical to CRC32 with the same parameters, e.g.
+//
+//    SlicingCRC32<8, CRC32_CASTAGNOLI_POLYNOME, CRC32_CASTAGNOLI_REV_IN> crc(
+//      CRC32_CASTAGNOLI_INITIAL, CRC32_CASTAGNOLI_XOR_OUT, CRC32_CASTAGNOLI_REV_OUT);
+//
+//  The tables take slices KB of memory, see CrcSlicing.h.
+
+
+#include "CrcParameters.h"
+#include "CrcClass.h"
+
+
+template <uint8_t slices = 8, uint32_t polynome = CRC32_POLYNOME, bool reverseIn = CRC32_REV_IN>
+using SlicingCRC32 = CrcClass<32, polynome, reverseIn, CrcSlicingPolicy<slices>,
+                              CRC32_INITIAL, CRC32_XOR_OUT, CRC32_REV_OUT>;
+
+
+//  -- END OF FILE --
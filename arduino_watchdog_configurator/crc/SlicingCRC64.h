@@ -0,0 +1,23 @@
+#pragma once
+//
+//    FILE: SlicingCRC64.h
+// PURPOSE: class for slicing-by-4/8/16 CRC64 (host side bulk checksumming)
+//
+//  Results are identical to CRC64 with the same parameters, e.g.
+//
+//    SlicingCRC64<8, CRC64_ISO64_POLYNOME, CRC64_ISO64_REV_IN> crc(
+//      CRC64_ISO64_INITIAL, CRC64_ISO64_XOR_OUT, CRC64_ISO64_REV_OUT);
+//
+//  The tables take 2 * slices KB of memory, see CrcSlicing.h.
+
+
+#include "CrcParameters.h"
+#include "CrcClass.h"
+
+
+template <uint8_t slices = 8, uint64_t polynome = CRC64_POLYNOME, bool reverseIn = CRC64_REV_IN>
+using SlicingCRC64 = CrcClass<64, polynome, reverseIn, CrcSlicingPolicy<slices>,
+                              CRC64_INITIAL, CRC64_XOR_OUT, CRC64_REV_OUT>;
+
+
+//  -- END OF FILE --
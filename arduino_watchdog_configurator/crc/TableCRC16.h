@@ -0,0 +1,26 @@
+#pragma once
+//
+//    FILE: TableCRC16.h
+// PURPOSE: Arduino class for table driven CRC16
+//
+//  One table lookup per byte instead of eight conditional shifts.
+//  Polynome and reverseIn select the table at compile time,
+//  e.g. for CRC16_MODBUS:
+//
+//    TableCRC16<CRC16_MODBUS_POLYNOME, CRC16_MODBUS_REV_IN> crc(
+//      CRC16_MODBUS_INITIAL, CRC16_MODBUS_XOR_OUT, CRC16_MODBUS_REV_OUT);
+//
+//  The table costs 512 bytes of flash per polynome / reverseIn pair.
+//  Results are identical to CRC16 with the same parameters.
+
+
+#include "CrcParameters.h"
+#include "CrcClass.h"
+
+
+template <uint16_t polynome = CRC16_POLYNOME, bool reverseIn = CRC16_REV_IN>
+using TableCRC16 = CrcClass<16, polynome, reverseIn, CrcBytePolicy,
+                            CRC16_INITIAL, CRC16_XOR_OUT, CRC16_REV_OUT>;
+
+
+//  -- END OF FILE --
@@ -0,0 +1,16 @@
+#ifndef WD_CRC_HPP
+#define WD_CRC_HPP
+
+#include "../crc/CRC.h"
+
+// CRC implementation policy of the firmware, selected per board by the
+// Makefile (CRC_POLICY) as the library wide CRC_DEFAULT_POLICY, so
+// calcCRC16() uses the same table, see crc/CrcPolicy.h
+#ifndef WD_CRC_POLICY
+#define WD_CRC_POLICY CRC_DEFAULT_POLICY
+#endif
+
+// CRC16 used by the watchdog input and response frames
+typedef CRC_PRESET_POLICY(16, CRC16, WD_CRC_POLICY) WdCrc16;
+
+#endif // WD_CRC_HPP
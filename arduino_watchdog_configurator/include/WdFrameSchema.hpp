@@ -0,0 +1,452 @@
+#ifndef WD_FRAME_SCHEMA_HPP
+#define WD_FRAME_SCHEMA_HPP
+
+#include "WdSyncScanner.hpp"
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Compile time description of a watchdog frame:
+//
+//   start byte 1 | start byte 2 | field 0 | field 1 | ... | CRC
+//
+// WdFrameSchema<'W', 'C', WdCrc16, 1> is the input frame with a one byte
+// command, WdFrameSchema<'W', 'R', WdCrc16, 1, StatusSize> the response.
+// Field offsets and sizes, the encoder and both decoders are generated
+// from the template parameters, nothing is interpreted at run time. The
+// CRC covers everything before it and is sent in the byte order that
+// gives Crc::residue(), most significant byte first unless reflected.
+// WdVarFrameSchema adds a length byte for payloads of varying size.
+
+// Decoder result per byte or frame, values match
+// WdInputByteProcessor::WdInputMessageProcessState
+enum class WdDecodeState : uint8_t {
+  Incomplete = 0,
+  Complete = 1,
+  InvalidCrc = 2
+};
+
+namespace wd_detail {
+
+template <size_t... Sizes> struct FieldSizeSum;
+
+template <> struct FieldSizeSum<> { static constexpr size_t value = 0; };
+
+template <size_t First, size_t... Rest> struct FieldSizeSum<First, Rest...> {
+  static constexpr size_t value = First + FieldSizeSum<Rest...>::value;
+};
+
+// Size and payload offset of field Index
+template <size_t Index, size_t... Sizes> struct FieldAt;
+
+template <size_t First, size_t... Rest> struct FieldAt<0, First, Rest...> {
+  static constexpr size_t size = First;
+  static constexpr size_t offset = 0;
+};
+
+template <size_t Index, size_t First, size_t... Rest>
+struct FieldAt<Index, First, Rest...> {
+  static constexpr size_t size = FieldAt<Index - 1, Rest...>::size;
+  static constexpr size_t offset = First + FieldAt<Index - 1, Rest...>::offset;
+};
+
+// CRC bytes in transmission order, the order that gives Crc::residue():
+// most significant byte first unless reflected
+template <typename Crc> void writeCrc(uint8_t *at, typename Crc::Type crc) {
+  const size_t size = Crc::getWidth() / 8;
+  for (size_t i = 0; i < size; ++i) {
+    at[i] = static_cast<uint8_t>(
+        Crc::getReverseIn() ? crc >> (8 * i) : crc >> (8 * (size - 1 - i)));
+  }
+}
+
+template <typename Crc> typename Crc::Type readCrc(const uint8_t *at) {
+  const size_t size = Crc::getWidth() / 8;
+  typename Crc::Type crc = 0;
+  for (size_t i = 0; i < size; ++i) {
+    crc = static_cast<typename Crc::Type>(
+        (crc << 8) | at[Crc::getReverseIn() ? size - 1 - i : i]);
+  }
+  return crc;
+}
+
+// Bulk decoding shared by the decoders: bytes up to end are fed to
+// decoder, garbage is skipped with wdFindSyncPattern() and the rest of a
+// frame is taken in one piece. onFrame(state, frame) is called for every
+// complete frame, decoding stops after one when it returns false. A frame
+// lying wholly in the buffer is checked and passed in place, frame then
+// points into bytes; only frames split across buffers are copied. Returns
+// the position after the last byte used.
+template <typename Schema, typename Decoder, typename OnFrame>
+const uint8_t *feedBuffer(Decoder &decoder, const uint8_t *bytes,
+                          const uint8_t *end, OnFrame onFrame) {
+  while (bytes < end) {
+    if (decoder.inFrame()) {
+      const WdDecodeState state = decoder.feedRest(bytes, end);
+      if (state != WdDecodeState::Incomplete &&
+          !onFrame(state, decoder.frame())) {
+        break;
+      }
+      continue;
+    }
+    if (decoder.idle()) {
+      const uint8_t *start = wdFindSyncPattern(
+          bytes, end, Schema::kStartByte1, Schema::kStartByte2);
+      if (start == end) {
+        // A start byte at the end may begin a frame in the next buffer
+        if (end[-1] == Schema::kStartByte1) {
+          decoder.feed(end[-1]);
+        }
+        return end;
+      }
+      bytes = start;
+      const size_t size = Schema::frameAt(bytes, end - bytes);
+      if (size != 0) {
+        const uint8_t *const frame = bytes;
+        bytes += size;
+        if (!onFrame(Schema::check(frame, size), frame)) {
+          break;
+        }
+        continue;
+      }
+    }
+    // Start bytes and length of a frame running past end
+    decoder.feed(*bytes++);
+  }
+  return bytes;
+}
+
+} // namespace wd_detail
+
+template <uint8_t StartByte1, uint8_t StartByte2, typename Crc,
+          size_t... FieldSizes>
+struct WdFrameSchema {
+  static constexpr uint8_t kStartByte1 = StartByte1;
+  static constexpr uint8_t kStartByte2 = StartByte2;
+  static constexpr size_t kFieldCount = sizeof...(FieldSizes);
+  static constexpr size_t kPayloadOffset = 2;
+  static constexpr size_t kPayloadSize =
+      wd_detail::FieldSizeSum<FieldSizes...>::value;
+  static constexpr size_t kCrcOffset = kPayloadOffset + kPayloadSize;
+  static constexpr size_t kCrcSize = Crc::getWidth() / 8;
+  static constexpr size_t kFrameSize = kCrcOffset + kCrcSize;
+
+  using CrcType = typename Crc::Type;
+  using DecodeState = WdDecodeState;
+
+  static_assert(Crc::getWidth() % 8 == 0, "The frame CRC must be whole bytes");
+  static_assert(kFrameSize < 256,
+                "The decoder counts frame bytes in a uint8_t");
+
+  // Position of field Index in the frame
+  template <size_t Index> struct Field {
+    static_assert(Index < kFieldCount, "Field index out of range");
+    static constexpr size_t kOffset =
+        kPayloadOffset + wd_detail::FieldAt<Index, FieldSizes...>::offset;
+    static constexpr size_t kSize =
+        wd_detail::FieldAt<Index, FieldSizes...>::size;
+  };
+
+  template <size_t Index> static uint8_t *field(uint8_t *frame) {
+    return frame + Field<Index>::kOffset;
+  }
+
+  template <size_t Index> static const uint8_t *field(const uint8_t *frame) {
+    return frame + Field<Index>::kOffset;
+  }
+
+  // Encoder: writes the start bytes and the CRC around the fields already
+  // stored in frame, which holds kFrameSize bytes
+  static void seal(uint8_t *frame) {
+    frame[0] = kStartByte1;
+    frame[1] = kStartByte2;
+    wd_detail::writeCrc<Crc>(frame + kCrcOffset,
+                             Crc::compute(frame, kCrcOffset));
+  }
+
+  // The CRC stored in frame, in the byte order written by seal()
+  static CrcType readCrc(const uint8_t *frame) {
+    return wd_detail::readCrc<Crc>(frame + kCrcOffset);
+  }
+
+  // Encoder from kPayloadSize bytes holding the fields in order
+  static void encode(uint8_t *frame, const uint8_t *payload) {
+    memcpy(frame + kPayloadOffset, payload, kPayloadSize);
+    seal(frame);
+  }
+
+  // True for a complete intact frame of kFrameSize bytes
+  static bool verify(const uint8_t *frame) {
+    return frame[0] == kStartByte1 && frame[1] == kStartByte2 &&
+           Crc::verify(frame, kFrameSize);
+  }
+
+  // Size of the frame at bytes when it lies wholly in the available bytes,
+  // 0 when it does not
+  static size_t frameAt(const uint8_t *bytes, size_t available) {
+    return available >= kFrameSize && bytes[0] == kStartByte1 &&
+                   bytes[1] == kStartByte2
+               ? kFrameSize
+               : 0;
+  }
+
+  static DecodeState check(const uint8_t *frame, size_t size) {
+    return Crc::verify(frame, size) ? DecodeState::Complete
+                                    : DecodeState::InvalidCrc;
+  }
+
+  // Decoder for a byte stream, one byte at a time or whole buffers. The
+  // CRC runs as the bytes arrive, the last byte only compares it with the
+  // residue. frame() holds the last frame until the next one starts.
+  class Decoder {
+  public:
+    Decoder() : mFrame{}, mLength{0}, mCrc{} {}
+
+    void reset() {
+      mLength = 0;
+      mCrc.restart();
+    }
+
+    // Waiting for start byte 1
+    bool idle() const { return mLength == 0; }
+
+    // Start bytes received, every further byte belongs to the frame
+    bool inFrame() const { return mLength >= kPayloadOffset; }
+
+    const uint8_t *frame() const { return mFrame; }
+
+    DecodeState feed(const uint8_t byte) {
+      // Inside a frame, the common case
+      if (mLength >= kPayloadOffset) {
+        mFrame[mLength++] = byte;
+        mCrc.add(byte);
+        return mLength == kFrameSize ? finish() : DecodeState::Incomplete;
+      }
+      if (mLength == 1) {
+        if (byte == kStartByte2) {
+          mFrame[mLength++] = byte;
+          mCrc.add(byte);
+          return DecodeState::Incomplete;
+        }
+        reset();
+      }
+      // Start byte 1, also when repeated before start byte 2
+      if (byte == kStartByte1) {
+        mFrame[mLength++] = byte;
+        mCrc.add(byte);
+      }
+      return DecodeState::Incomplete;
+    }
+
+    // Once inFrame(), take the rest of the frame from bytes up to end in
+    // one pass and advance bytes past it
+    DecodeState feedRest(const uint8_t *&bytes, const uint8_t *end) {
+      size_t part = kFrameSize - mLength;
+      if (part > static_cast<size_t>(end - bytes)) {
+        part = end - bytes;
+      }
+      for (const uint8_t *const stop = bytes + part; bytes < stop; ++bytes) {
+        mFrame[mLength++] = *bytes;
+        mCrc.add(*bytes);
+      }
+      return mLength == kFrameSize ? finish() : DecodeState::Incomplete;
+    }
+
+    // Feed bytes up to end, see wd_detail::feedBuffer()
+    template <typename OnFrame>
+    const uint8_t *feed(const uint8_t *bytes, const uint8_t *end,
+                        OnFrame onFrame) {
+      return wd_detail::feedBuffer<WdFrameSchema>(*this, bytes, end, onFrame);
+    }
+
+  private:
+    DecodeState finish() {
+      const DecodeState state =
+          mCrc.verify() ? DecodeState::Complete : DecodeState::InvalidCrc;
+      reset();
+      return state;
+    }
+
+    uint8_t mFrame[kFrameSize];
+    uint8_t mLength;
+    Crc mCrc;
+  };
+};
+
+// Variable length frame:
+//
+//   start byte 1 | start byte 2 | length | payload | CRC
+//
+// length counts the payload bytes, at most MaxPayloadSize. The CRC covers
+// everything before it and is sent as in WdFrameSchema.
+template <uint8_t StartByte1, uint8_t StartByte2, typename Crc,
+          size_t MaxPayloadSize>
+struct WdVarFrameSchema {
+  static constexpr uint8_t kStartByte1 = StartByte1;
+  static constexpr uint8_t kStartByte2 = StartByte2;
+  static constexpr size_t kLengthOffset = 2;
+  static constexpr size_t kPayloadOffset = 3;
+  static constexpr size_t kMaxPayloadSize = MaxPayloadSize;
+  static constexpr size_t kCrcSize = Crc::getWidth() / 8;
+  static constexpr size_t kMinFrameSize = kPayloadOffset + kCrcSize;
+  static constexpr size_t kMaxFrameSize = kMinFrameSize + kMaxPayloadSize;
+
+  using CrcType = typename Crc::Type;
+  using DecodeState = WdDecodeState;
+
+  static_assert(Crc::getWidth() % 8 == 0, "The frame CRC must be whole bytes");
+  static_assert(kMaxFrameSize < 256,
+                "The length byte and the decoder count in a uint8_t");
+
+  static constexpr size_t frameSize(size_t payloadSize) {
+    return kMinFrameSize + payloadSize;
+  }
+
+  static size_t payloadSize(const uint8_t *frame) {
+    return frame[kLengthOffset];
+  }
+
+  static uint8_t *payload(uint8_t *frame) { return frame + kPayloadOffset; }
+
+  static const uint8_t *payload(const uint8_t *frame) {
+    return frame + kPayloadOffset;
+  }
+
+  // Encoder: writes the start bytes, the length and the CRC around the
+  // payloadSize bytes already stored at payload(frame). Returns the frame
+  // size.
+  static size_t seal(uint8_t *frame, size_t payloadSize) {
+    frame[0] = kStartByte1;
+    frame[1] = kStartByte2;
+    frame[kLengthOffset] = static_cast<uint8_t>(payloadSize);
+    const size_t crcOffset = kPayloadOffset + payloadSize;
+    wd_detail::writeCrc<Crc>(frame + crcOffset, Crc::compute(frame, crcOffset));
+    return crcOffset + kCrcSize;
+  }
+
+  static size_t encode(uint8_t *frame, const uint8_t *payload,
+                       size_t payloadSize) {
+    memcpy(frame + kPayloadOffset, payload, payloadSize);
+    return seal(frame, payloadSize);
+  }
+
+  // The CRC stored in frame, in the byte order written by seal()
+  static CrcType readCrc(const uint8_t *frame) {
+    return wd_detail::readCrc<Crc>(frame + kPayloadOffset +
+                                   payloadSize(frame));
+  }
+
+  // Size of the frame at bytes when it lies wholly in the available bytes,
+  // 0 when it does not or its length is out of range
+  static size_t frameAt(const uint8_t *bytes, size_t available) {
+    if (available <= kLengthOffset || bytes[0] != kStartByte1 ||
+        bytes[1] != kStartByte2 || bytes[kLengthOffset] > kMaxPayloadSize) {
+      return 0;
+    }
+    const size_t size = frameSize(bytes[kLengthOffset]);
+    return size <= available ? size : 0;
+  }
+
+  // True for a complete intact frame in the available bytes from frame
+  static bool verify(const uint8_t *frame, size_t available) {
+    const size_t size = frameAt(frame, available);
+    return size != 0 && Crc::verify(frame, size);
+  }
+
+  static DecodeState check(const uint8_t *frame, size_t size) {
+    return Crc::verify(frame, size) ? DecodeState::Complete
+                                    : DecodeState::InvalidCrc;
+  }
+
+  // Decoder as WdFrameSchema::Decoder, the frame size follows from the
+  // length byte. A length out of range drops the frame.
+  class Decoder {
+  public:
+    Decoder() : mFrame{}, mLength{0}, mFrameSize{0}, mCrc{} {}
+
+    void reset() {
+      mLength = 0;
+      mCrc.restart();
+    }
+
+    // Waiting for start byte 1
+    bool idle() const { return mLength == 0; }
+
+    // Start bytes and length received, every further byte belongs to the
+    // frame
+    bool inFrame() const { return mLength >= kPayloadOffset; }
+
+    const uint8_t *frame() const { return mFrame; }
+
+    // Size of the last frame, or of the frame being received once inFrame()
+    size_t frameSize() const { return mFrameSize; }
+
+    DecodeState feed(const uint8_t byte) {
+      // Inside a frame, the common case
+      if (mLength >= kPayloadOffset) {
+        mFrame[mLength++] = byte;
+        mCrc.add(byte);
+        return mLength == mFrameSize ? finish() : DecodeState::Incomplete;
+      }
+      if (mLength == kLengthOffset) {
+        if (byte <= kMaxPayloadSize) {
+          mFrameSize = static_cast<uint8_t>(WdVarFrameSchema::frameSize(byte));
+          mFrame[mLength++] = byte;
+          mCrc.add(byte);
+          return DecodeState::Incomplete;
+        }
+        reset();
+      } else if (mLength == 1) {
+        if (byte == kStartByte2) {
+          mFrame[mLength++] = byte;
+          mCrc.add(byte);
+          return DecodeState::Incomplete;
+        }
+        reset();
+      }
+      // Start byte 1, also when repeated before start byte 2
+      if (byte == kStartByte1) {
+        mFrame[mLength++] = byte;
+        mCrc.add(byte);
+      }
+      return DecodeState::Incomplete;
+    }
+
+    // Once inFrame(), take the rest of the frame from bytes up to end in
+    // one pass and advance bytes past it
+    DecodeState feedRest(const uint8_t *&bytes, const uint8_t *end) {
+      size_t part = mFrameSize - mLength;
+      if (part > static_cast<size_t>(end - bytes)) {
+        part = end - bytes;
+      }
+      for (const uint8_t *const stop = bytes + part; bytes < stop; ++bytes) {
+        mFrame[mLength++] = *bytes;
+        mCrc.add(*bytes);
+      }
+      return mLength == mFrameSize ? finish() : DecodeState::Incomplete;
+    }
+
+    // Feed bytes up to end, see wd_detail::feedBuffer()
+    template <typename OnFrame>
+    const uint8_t *feed(const uint8_t *bytes, const uint8_t *end,
+                        OnFrame onFrame) {
+      return wd_detail::feedBuffer<WdVarFrameSchema>(*this, bytes, end,
+                                                     onFrame);
+    }
+
+  private:
+    DecodeState finish() {
+      const DecodeState state =
+          mCrc.verify() ? DecodeState::Complete : DecodeState::InvalidCrc;
+      reset();
+      return state;
+    }
+
+    uint8_t mFrame[kMaxFrameSize];
+    uint8_t mLength;
+    uint8_t mFrameSize;
+    Crc mCrc;
+  };
+};
+
+#endif // WD_FRAME_SCHEMA_HPP
@@ -0,0 +1,217 @@
+#ifndef WD_FRAME_VIEW_HPP
+#define WD_FRAME_VIEW_HPP
+
+#include "WdCrc.hpp"
+#include "WdFrameSchema.hpp"
+#include "WdInput.hpp"
+#include <stddef.h>
+#include <stdint.h>
+
+// Read only views of frames in a receive buffer. The fields are read in
+// place at the offsets of the frame schema and the CRC is checked over
+// the buffer, nothing is copied into message objects:
+//
+//   WdInputMsgView view(at, end - at);
+//   if (view.valid()) {
+//     dispatch(view.getCmd());
+//   }
+//
+// A view does not own its bytes, the buffer has to outlive it.
+
+// Response frame layout: start bytes, ack, status bytes, CRC16. Declared
+// here as WdResponse.hpp needs Arduino for its Array.
+template <size_t StatusSize>
+using WdResponseFrame = WdFrameSchema<'W', 'R', WdCrc16, 1, StatusSize>;
+
+// Response to a sequenced request: start bytes, sequence, ack, status
+// bytes, CRC16. The sequence is copied from the request.
+template <size_t StatusSize>
+using WdSequencedResponseFrame =
+    WdFrameSchema<'W', 'A', WdCrc16, 1, 1, StatusSize>;
+
+template <typename Schema> class WdFrameView {
+public:
+  using Frame = Schema;
+
+  constexpr WdFrameView(const uint8_t *bytes, size_t length)
+      : mBytes{bytes}, mLength{length} {}
+
+  // Frame size, bytes after it belong to the next frame
+  static constexpr size_t size() { return Frame::kFrameSize; }
+
+  const uint8_t *data() const { return mBytes; }
+
+  // The span holds a whole frame
+  constexpr bool complete() const { return mLength >= Frame::kFrameSize; }
+
+  // Whole frame with its start bytes and an intact CRC
+  bool valid() const { return complete() && Frame::verify(mBytes); }
+
+  // Field Index, Frame::Field<Index>::kSize bytes
+  template <size_t Index> const uint8_t *field() const {
+    return Frame::template field<Index>(mBytes);
+  }
+
+  // Field Index as a number, most significant byte first
+  template <size_t Index, typename T = uint8_t> T get() const {
+    static_assert(sizeof(T) >= Frame::template Field<Index>::kSize,
+                  "Field does not fit the requested type");
+    const uint8_t *bytes = field<Index>();
+    T value = 0;
+    for (size_t i = 0; i < Frame::template Field<Index>::kSize; ++i) {
+      value = static_cast<T>((value << 8) | bytes[i]);
+    }
+    return value;
+  }
+
+  // The CRC as received
+  typename Frame::CrcType getCrc() const { return Frame::readCrc(mBytes); }
+
+private:
+  const uint8_t *mBytes;
+  size_t mLength;
+};
+
+// Input frame, see WdInputMsg
+class WdInputMsgView : public WdFrameView<WdInputMsg::Frame> {
+public:
+  constexpr WdInputMsgView(const uint8_t *bytes, size_t length)
+      : WdFrameView<WdInputMsg::Frame>{bytes, length} {}
+
+  uint8_t getCmd() const { return get<WdInputMsg::kCmdField>(); }
+};
+
+// Sequenced input frame, see WdInputMsg::SequencedFrame
+class WdSequencedInputMsgView
+    : public WdFrameView<WdInputMsg::SequencedFrame> {
+public:
+  constexpr WdSequencedInputMsgView(const uint8_t *bytes, size_t length)
+      : WdFrameView<WdInputMsg::SequencedFrame>{bytes, length} {}
+
+  uint8_t getSequence() const { return get<WdInputMsg::kSequenceField>(); }
+
+  uint8_t getCmd() const { return get<WdInputMsg::kSequencedCmdField>(); }
+};
+
+// Response frame, see WdResponse
+template <size_t StatusSize = 1>
+class WdResponseView : public WdFrameView<WdResponseFrame<StatusSize>> {
+  using Base = WdFrameView<WdResponseFrame<StatusSize>>;
+
+public:
+  static constexpr size_t kAckField = 0;
+  static constexpr size_t kStatusField = 1;
+
+  constexpr WdResponseView(const uint8_t *bytes, size_t length)
+      : Base{bytes, length} {}
+
+  uint8_t getAck() const { return this->template get<kAckField>(); }
+
+  // Status byte index, 0 when out of range
+  uint8_t getStatus(size_t index = 0) const {
+    return index < StatusSize ? this->template field<kStatusField>()[index]
+                              : 0;
+  }
+};
+
+// Sequenced response frame, matched to its request by getSequence()
+template <size_t StatusSize = 1>
+class WdSequencedResponseView
+    : public WdFrameView<WdSequencedResponseFrame<StatusSize>> {
+  using Base = WdFrameView<WdSequencedResponseFrame<StatusSize>>;
+
+public:
+  static constexpr size_t kSequenceField = 0;
+  static constexpr size_t kAckField = 1;
+  static constexpr size_t kStatusField = 2;
+
+  constexpr WdSequencedResponseView(const uint8_t *bytes, size_t length)
+      : Base{bytes, length} {}
+
+  uint8_t getSequence() const { return this->template get<kSequenceField>(); }
+
+  uint8_t getAck() const { return this->template get<kAckField>(); }
+
+  // Status byte index, 0 when out of range
+  uint8_t getStatus(size_t index = 0) const {
+    return index < StatusSize ? this->template field<kStatusField>()[index]
+                              : 0;
+  }
+};
+
+// Batch frame, see WdInputMsg::BatchFrame. Command i is answered in
+// status byte i of the response.
+class WdInputBatchView {
+public:
+  using Frame = WdInputMsg::BatchFrame;
+
+  constexpr WdInputBatchView(const uint8_t *bytes, size_t length)
+      : mBytes{bytes}, mLength{length} {}
+
+  const uint8_t *data() const { return mBytes; }
+
+  // The span holds a whole frame with a length in range
+  bool complete() const { return Frame::frameAt(mBytes, mLength) != 0; }
+
+  // Frame size given by the length byte, once complete()
+  size_t size() const { return Frame::frameSize(payloadSize()); }
+
+  // Whole frame with an intact CRC and commands filling the payload
+  bool valid() const { return Frame::verify(mBytes, mLength) && wellFormed(); }
+
+  size_t payloadSize() const { return Frame::payloadSize(mBytes); }
+
+  const uint8_t *payload() const { return Frame::payload(mBytes); }
+
+  // The CRC as received
+  Frame::CrcType getCrc() const { return Frame::readCrc(mBytes); }
+
+  // Calls onCommand(index, cmd, value, length) for every command, value
+  // pointing at its length bytes. Stops at a command running past the
+  // payload. Returns the number of commands reported.
+  template <typename OnCommand>
+  size_t forEachCommand(OnCommand onCommand) const {
+    size_t used = 0;
+    return walk(onCommand, used);
+  }
+
+  size_t count() const {
+    size_t used = 0;
+    return walk(IgnoreCommand{}, used);
+  }
+
+  // The commands fill the payload exactly
+  bool wellFormed() const {
+    size_t used = 0;
+    walk(IgnoreCommand{}, used);
+    return used == payloadSize();
+  }
+
+private:
+  const uint8_t *mBytes;
+  size_t mLength;
+
+  struct IgnoreCommand {
+    void operator()(size_t, uint8_t, const uint8_t *, uint8_t) const {}
+  };
+
+  template <typename OnCommand>
+  size_t walk(OnCommand onCommand, size_t &used) const {
+    const uint8_t *const commands = payload();
+    const size_t size = payloadSize();
+    size_t count = 0;
+    while (size - used >= WdInputMsg::kCommandHeaderSize) {
+      const uint8_t length = commands[used + 1];
+      if (length > size - used - WdInputMsg::kCommandHeaderSize) {
+        break;
+      }
+      onCommand(count, commands[used],
+                commands + used + WdInputMsg::kCommandHeaderSize, length);
+      used += WdInputMsg::kCommandHeaderSize + length;
+      count++;
+    }
+    return count;
+  }
+};
+
+#endif // WD_FRAME_VIEW_HPP
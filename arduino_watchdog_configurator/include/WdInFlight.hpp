@@ -0,0 +1,91 @@
+#ifndef WD_IN_FLIGHT_HPP
+#define WD_IN_FLIGHT_HPP
+
+#include "WdInput.hpp"
+#include <stddef.h>
+#include <stdint.h>
+
+// Host side table of sequenced requests sent but not answered yet, so
+// several requests can be in flight. Responses are matched by their
+// sequence number in any order. Sequence numbers count up modulo 256 and
+// request n uses slot n % Capacity: a slot is only reused once its
+// request was answered or expired, and a late answer for an expired
+// request does not match the request now in its slot.
+template <size_t Capacity> class WdInFlight {
+private:
+  static_assert(Capacity > 0 && Capacity <= 128 &&
+                    (Capacity & (Capacity - 1)) == 0,
+                "Capacity must be a power of two up to 128");
+
+  static constexpr uint8_t kSlotMask = Capacity - 1;
+
+  struct Slot {
+    ulong mSentTimeMs; // Time the request was sent
+    uint8_t mSequence; // Sequence number of the request
+    uint8_t mCmd;      // Command of the request
+    bool mBusy;        // Waiting for its response
+  };
+
+  Slot mSlots[Capacity];
+  uint8_t mNextSequence; // Sequence number of the next request
+  uint8_t mCount;        // Requests in flight
+
+public:
+  WdInFlight() : mSlots{}, mNextSequence{0}, mCount{0} {}
+
+  // Take the sequence number for a request of command cmd sent at
+  // currentTimeMs. False while the request in its slot is unanswered.
+  bool begin(uint8_t cmd, ulong currentTimeMs, uint8_t &sequence) {
+    Slot &slot = mSlots[mNextSequence & kSlotMask];
+    if (slot.mBusy) {
+      return false;
+    }
+    slot.mSentTimeMs = currentTimeMs;
+    slot.mSequence = mNextSequence;
+    slot.mCmd = cmd;
+    slot.mBusy = true;
+    sequence = mNextSequence++;
+    mCount++;
+    return true;
+  }
+
+  // Match the response with sequence number sequence. True with the
+  // command of its request, false for an unknown or repeated answer.
+  bool complete(uint8_t sequence, uint8_t &cmd) {
+    Slot &slot = mSlots[sequence & kSlotMask];
+    if (!slot.mBusy || slot.mSequence != sequence) {
+      return false;
+    }
+    slot.mBusy = false;
+    cmd = slot.mCmd;
+    mCount--;
+    return true;
+  }
+
+  // Drop the requests sent more than timeoutMs before currentTimeMs,
+  // onExpired(sequence, cmd) is called for each. Returns the number
+  // dropped.
+  template <typename OnExpired>
+  size_t expire(ulong currentTimeMs, ulong timeoutMs, OnExpired onExpired) {
+    size_t expired = 0;
+    for (size_t i = 0; i < Capacity; ++i) {
+      Slot &slot = mSlots[i];
+      if (slot.mBusy && currentTimeMs - slot.mSentTimeMs > timeoutMs) {
+        slot.mBusy = false;
+        mCount--;
+        expired++;
+        onExpired(slot.mSequence, slot.mCmd);
+      }
+    }
+    return expired;
+  }
+
+  size_t size() const { return mCount; }
+
+  bool empty() const { return mCount == 0; }
+
+  // The next request has to wait for an answer or expiry
+  bool full() const { return mSlots[mNextSequence & kSlotMask].mBusy; }
+};
+
+#endif // WD_IN_FLIGHT_HPP
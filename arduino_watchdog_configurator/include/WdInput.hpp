@@ -1,6 +1,8 @@
 #ifndef WD_INPUT_MSG_HPP
 #define WD_INPUT_MSG_HPP
 
+#include "WdCrc.hpp"
+#include "WdFrameSchema.hpp"
 #include <stdint.h>
 
 using ulong = unsigned long;
@@ -10,7 +12,8 @@ private:
   const uint8_t mStartBytes[2] = {kInputMsgStartByte1,
                                   kInputMsgStartByte2}; // Start bytes
   uint8_t mCmd;                                         // Command byte
-  uint16_t mCrc16;                                      // CRC16 checksum
+  uint8_t mSequence;                                    // Sequence number
+  bool mSequenced;                                      // Sequence is sent
 
 public:
   static constexpr uint8_t kInputMsgStartByte1 = 'W'; // Start byte 1
@@ -29,30 +32,135 @@ public:
   };
 
   // Constructor
-  WdInputMsg() : mCmd(static_cast<uint8_t>(Command::Disable)), mCrc16(0x0000) {}
+  WdInputMsg()
+      : mCmd(static_cast<uint8_t>(Command::Disable)), mSequence(0),
+        mSequenced(false) {}
 
   // Getter for mStartByte1 aka mStartBytes[0]
-  const uint8_t getStartByte1() const { return mStartBytes[0]; }
+  uint8_t getStartByte1() const { return mStartBytes[0]; }
 
   // Getter for mStartByte2 aka mStartBytes[0]
-  const uint8_t getStartByte2() const { return mStartBytes[1]; }
+  uint8_t getStartByte2() const { return mStartBytes[1]; }
 
   // Getter for mcmd
-  const uint8_t getCmd() const { return mCmd; }
-
-  // Getter for mcrc16
-  const uint16_t getCRC16() const { return mCrc16; }
+  uint8_t getCmd() const { return mCmd; }
 
   // Setter for mcmd
   void setCmd(Command command) { mCmd = static_cast<uint8_t>(command); }
   void setCmd(uint8_t command) { mCmd = command; }
 
-  // Setter for mcrc16
-  void setCrc16(uint16_t crc) { mCrc16 = crc; }
-  void setCrc16Msb(uint8_t crcMsb) {
-    mCrc16 = (crcMsb << 8) | (mCrc16 & 0x00FF);
+  // Getter for mSequence, valid when isSequenced()
+  uint8_t getSequence() const { return mSequence; }
+
+  bool isSequenced() const { return mSequenced; }
+
+  // Send with a sequence number, echoed in the response
+  void setSequence(uint8_t sequence) {
+    mSequence = sequence;
+    mSequenced = true;
+  }
+
+  void clearSequence() { mSequenced = false; }
+
+  // Frame layout: start bytes, command, CRC16
+  using Frame =
+      WdFrameSchema<kInputMsgStartByte1, kInputMsgStartByte2, WdCrc16, 1>;
+  static constexpr size_t kCmdField = 0;
+
+  // Sequenced frame layout: start bytes, sequence, command, CRC16. The
+  // response echoes the sequence, so several requests can be in flight.
+  static constexpr uint8_t kSequencedMsgStartByte2 = 'S'; // Start byte 2
+  using SequencedFrame = WdFrameSchema<kInputMsgStartByte1,
+                                       kSequencedMsgStartByte2, WdCrc16, 1, 1>;
+  static constexpr size_t kSequenceField = 0;
+  static constexpr size_t kSequencedCmdField = 1;
+
+  // Write the frame of this message, a SequencedFrame when isSequenced(),
+  // and return its size
+  size_t encode(uint8_t *frame) const {
+    if (mSequenced) {
+      *SequencedFrame::field<kSequenceField>(frame) = mSequence;
+      *SequencedFrame::field<kSequencedCmdField>(frame) = mCmd;
+      SequencedFrame::seal(frame);
+      return SequencedFrame::kFrameSize;
+    }
+    *Frame::field<kCmdField>(frame) = mCmd;
+    Frame::seal(frame);
+    return Frame::kFrameSize;
+  }
+
+  // Take the command from a decoded frame
+  void decode(const uint8_t *frame) {
+    mCmd = *Frame::field<kCmdField>(frame);
+    mSequenced = false;
+  }
+
+  // Take the sequence and command from a decoded sequenced frame
+  void decodeSequenced(const uint8_t *frame) {
+    mCmd = *SequencedFrame::field<kSequencedCmdField>(frame);
+    setSequence(*SequencedFrame::field<kSequenceField>(frame));
+  }
+
+  // Batch frame: start bytes, length, commands, CRC16. Each command is
+  // its command byte, the length of its value and the value (TLV). The
+  // batch is answered by one response, status byte i for command i.
+  static constexpr uint8_t kBatchMsgStartByte2 = 'B'; // Batch start byte 2
+  static constexpr size_t kMaxBatchPayloadSize = 32;  // Batch payload bytes
+  static constexpr size_t kCommandHeaderSize = 2;     // Command, value length
+  static constexpr size_t kMaxBatchCommands =
+      kMaxBatchPayloadSize / kCommandHeaderSize; // Commands without value
+
+  using BatchFrame = WdVarFrameSchema<kInputMsgStartByte1, kBatchMsgStartByte2,
+                                      WdCrc16, kMaxBatchPayloadSize>;
+};
+
+// Commands collected for one batch frame, see WdInputMsg::BatchFrame
+class WdInputBatch {
+private:
+  uint8_t mPayload[WdInputMsg::kMaxBatchPayloadSize]; // Commands as TLV
+  uint8_t mSize;                                      // Payload bytes used
+  uint8_t mCount;                                     // Number of commands
+
+public:
+  WdInputBatch() : mPayload{}, mSize{0}, mCount{0} {}
+
+  // Append a command with length value bytes, false when it does not fit
+  bool add(uint8_t command, const uint8_t *value = nullptr,
+           uint8_t length = 0) {
+    if (WdInputMsg::kCommandHeaderSize + length >
+        WdInputMsg::kMaxBatchPayloadSize - mSize) {
+      return false;
+    }
+    mPayload[mSize++] = command;
+    mPayload[mSize++] = length;
+    for (uint8_t i = 0; i < length; ++i) {
+      mPayload[mSize++] = value[i];
+    }
+    mCount++;
+    return true;
+  }
+
+  bool add(WdInputMsg::Command command, const uint8_t *value = nullptr,
+           uint8_t length = 0) {
+    return add(static_cast<uint8_t>(command), value, length);
+  }
+
+  void clear() {
+    mSize = 0;
+    mCount = 0;
+  }
+
+  size_t count() const { return mCount; }
+
+  size_t payloadSize() const { return mSize; }
+
+  // Size of the encoded frame
+  size_t frameSize() const { return WdInputMsg::BatchFrame::frameSize(mSize); }
+
+  // Write the frame, frameSize() bytes, and return its size
+  size_t encode(uint8_t *frame) const {
+    return WdInputMsg::BatchFrame::encode(frame, mPayload, mSize);
   }
-  void setCrc16Lsb(uint16_t crcLsb) { mCrc16 = (mCrc16 & 0xFF00) | crcLsb; }
 };
 
 #endif // WD_INPUT_MSG_HPP
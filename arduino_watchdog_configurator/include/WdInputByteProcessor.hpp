@@ -1,6 +1,7 @@
 #ifndef WD_INPUT_BYTE_PROCESSOR_HPP
 #define WD_INPUT_BYTE_PROCESSOR_HPP
 
+#include "WdFrameView.hpp"
 #include "WdInput.hpp"
 #include <stdint.h>
 
@@ -8,74 +9,130 @@ class WdInputByteProcessor {
 
 public:
   WdInputByteProcessor(WdInputMsg &wdInputMsg)
-      : mLastReceivedTime{0}, mWdInputMsg{wdInputMsg},
-        mCurrentState{WdInputProcessState::WaitForStartByte1} {}
+      : mLastReceivedTime{0}, mWdInputMsg{wdInputMsg}, mDecoder{},
+        mSequencedDecoder{}, mBatchDecoder{}, mBatchFrame{nullptr} {}
 
   WdInputByteProcessor() = delete;
 
-  enum class WdInputProcessState {
-    WaitForStartByte1,
-    WaitForStartByte2,
-    WaitForCmd,
-    WaitForCrc1,
-    WaitForCrc2
-  };
-
   enum class WdInputMessageProcessState : uint8_t {
     InputMessageIncomplete = 0,
-    InputMessageComplete = 1
+    InputMessageComplete = 1,
+    InputMessageInvalidCrc = 2,
+    InputBatchComplete = 3,
+    InputSequencedComplete = 4
   };
 
+  // Process one byte. InputMessageComplete and InputSequencedComplete
+  // update the input message, the latter with the sequence number to
+  // echo. InputBatchComplete makes the batch available through
+  // getBatch().
   WdInputMessageProcessState processByte(const uint8_t newByteIn,
                                          ulong currentTimeMs) {
 
-    WdInputMessageProcessState retInputMsgProcessState =
-        WdInputMessageProcessState::InputMessageIncomplete;
-
     // Check for timeout in receiving data
-    if ((mCurrentState != WdInputProcessState::WaitForStartByte1) &&
-        (currentTimeMs - mLastReceivedTime > kMsgTimeoutThresholdMs)) {
+    if (timedOut(currentTimeMs)) {
       resetStateMachine();
-      return retInputMsgProcessState;
+      return WdInputMessageProcessState::InputMessageIncomplete;
     }
+    mLastReceivedTime = currentTimeMs;
 
-    // State machine to process the input message byte by byte
-    switch (mCurrentState) {
-    case WdInputProcessState::WaitForStartByte1:
-      if (newByteIn == mWdInputMsg.getStartByte1()) {
-        mCurrentState = WdInputProcessState::WaitForStartByte2;
-      }
-      break;
+    const WdInputMessageProcessState state = stepByte(newByteIn);
+    if (state == WdInputMessageProcessState::InputBatchComplete) {
+      accept(state, mBatchDecoder.frame());
+    } else if (state == WdInputMessageProcessState::InputSequencedComplete) {
+      accept(state, mSequencedDecoder.frame());
+    } else {
+      accept(state, mDecoder.frame());
+    }
+    return state;
+  }
 
-    case WdInputProcessState::WaitForStartByte2:
-      if (newByteIn == mWdInputMsg.getStartByte2()) {
-        mCurrentState = WdInputProcessState::WaitForCmd;
-      } else {
-        resetStateMachine();
-      }
-      break;
-
-    case WdInputProcessState::WaitForCmd:
-      mWdInputMsg.setCmd(newByteIn);
-      mCurrentState = WdInputProcessState::WaitForCrc1;
-      break;
-
-    case WdInputProcessState::WaitForCrc1:
-      mWdInputMsg.setCrc16Msb(newByteIn); // Store MSB of CRC
-      mCurrentState = WdInputProcessState::WaitForCrc2;
-      break;
-
-    case WdInputProcessState::WaitForCrc2:
-      // Store LSB of CRC
-      mWdInputMsg.setCrc16Lsb(newByteIn); // Store MSB of CRC
-      // Process the complete input message
-      retInputMsgProcessState =
-          WdInputMessageProcessState::InputMessageComplete;
-      resetStateMachine();
-      break;
+  // Commands of the last InputBatchComplete, valid until the next call
+  WdInputBatchView getBatch() const {
+    if (mBatchFrame == nullptr) {
+      return WdInputBatchView{nullptr, 0};
     }
+    return WdInputBatchView{mBatchFrame,
+                            WdInputMsg::BatchFrame::frameSize(
+                                WdInputMsg::BatchFrame::payloadSize(
+                                    mBatchFrame))};
+  }
+
+  // Process a whole receive buffer, received at currentTimeMs. Bytes
+  // before the start bytes are skipped with wdFindSyncPattern(). handler
+  // (state, msg) is called for every complete frame, with state
+  // InputMessageComplete, InputSequencedComplete, InputBatchComplete (see
+  // getBatch()) or InputMessageInvalidCrc. Returns the number of frames
+  // reported.
+  template <typename Handler>
+  size_t processBytes(const uint8_t *bytes, size_t length, ulong currentTimeMs,
+                      Handler handler) {
+    size_t frames = 0;
+    startBuffer(currentTimeMs);
+    parse(bytes, bytes + length,
+          [&](WdInputMessageProcessState state, const uint8_t *frame) -> bool {
+            accept(state, frame);
+            handler(state, static_cast<const WdInputMsg &>(mWdInputMsg));
+            frames++;
+            return true;
+          });
+    return frames;
+  }
+
+  // Process a whole receive buffer without copying the frames: handler
+  // (state, frame) gets the start of every complete frame, in bytes or,
+  // for a frame split across buffers, in the processor. The frame is
+  // valid during the call only and the input message is left as is.
+  // Read it through the view of its kind: WdInputMsgView for
+  // InputMessageComplete, WdSequencedInputMsgView for
+  // InputSequencedComplete and getBatch() for InputBatchComplete. With
+  // InputMessageInvalidCrc frame[1] tells the kind. Returns the number of
+  // frames reported.
+  template <typename Handler>
+  size_t processFrames(const uint8_t *bytes, size_t length,
+                       ulong currentTimeMs, Handler handler) {
+    size_t frames = 0;
+    startBuffer(currentTimeMs);
+    parse(bytes, bytes + length,
+          [&](WdInputMessageProcessState state, const uint8_t *frame) -> bool {
+            if (state == WdInputMessageProcessState::InputBatchComplete) {
+              mBatchFrame = frame;
+            }
+            handler(state, frame);
+            frames++;
+            return true;
+          });
+    return frames;
+  }
 
-    return retInputMsgProcessState;
+  // Process a whole receive buffer as above, copying the messages of
+  // intact frames to frames. Stops once maxFrames messages are stored;
+  // consumed is the number of bytes processed, pass the rest again.
+  // Sequenced messages keep their sequence number; batch frames are not
+  // stored, use the handler overloads for them.
+  // Returns the number of messages stored.
+  size_t processBytes(const uint8_t *bytes, size_t length, ulong currentTimeMs,
+                      WdInputMsg *frames, size_t maxFrames, size_t &consumed) {
+    size_t count = 0;
+    startBuffer(currentTimeMs);
+    if (maxFrames == 0) {
+      consumed = 0;
+      return 0;
+    }
+    const uint8_t *stop = parse(
+        bytes, bytes + length,
+        [&](WdInputMessageProcessState state, const uint8_t *frame) -> bool {
+          accept(state, frame);
+          if (state == WdInputMessageProcessState::InputMessageComplete) {
+            frames[count++].decode(frame);
+          } else if (state ==
+                     WdInputMessageProcessState::InputSequencedComplete) {
+            frames[count++].decodeSequenced(frame);
+          }
+          return count < maxFrames;
+        });
+    consumed = stop - bytes;
+    return count;
   }
 
 private:
@@ -83,13 +140,171 @@ private:
   ulong mLastReceivedTime; // Timestamp of last received byte
   WdInputMsg &mWdInputMsg;
 
-  WdInputProcessState mCurrentState;
+  // Frames being received, with their running CRC
+  WdInputMsg::Frame::Decoder mDecoder;
+  WdInputMsg::SequencedFrame::Decoder mSequencedDecoder;
+  WdInputMsg::BatchFrame::Decoder mBatchDecoder;
+
+  // Last batch frame, in the batch decoder or the caller's buffer
+  const uint8_t *mBatchFrame;
+
+  static WdInputMessageProcessState toProcessState(WdDecodeState state) {
+    return static_cast<WdInputMessageProcessState>(state);
+  }
+
+  static WdInputMessageProcessState toSequencedState(WdDecodeState state) {
+    return state == WdDecodeState::Complete
+               ? WdInputMessageProcessState::InputSequencedComplete
+               : toProcessState(state);
+  }
+
+  static WdInputMessageProcessState toBatchState(WdDecodeState state) {
+    return state == WdDecodeState::Complete
+               ? WdInputMessageProcessState::InputBatchComplete
+               : toProcessState(state);
+  }
+
+  // Take a complete frame into the input message or as the last batch
+  void accept(WdInputMessageProcessState state, const uint8_t *frame) {
+    if (state == WdInputMessageProcessState::InputMessageComplete) {
+      mWdInputMsg.decode(frame);
+    } else if (state == WdInputMessageProcessState::InputSequencedComplete) {
+      mWdInputMsg.decodeSequenced(frame);
+    } else if (state == WdInputMessageProcessState::InputBatchComplete) {
+      mBatchFrame = frame;
+    }
+  }
+
+  // One byte through the decoders: a frame takes every byte once its
+  // header is in, until then all decoders look for their start bytes
+  WdInputMessageProcessState stepByte(const uint8_t newByteIn) {
+    // Garbage between frames
+    if (newByteIn != WdInputMsg::kInputMsgStartByte1 && idle()) {
+      return WdInputMessageProcessState::InputMessageIncomplete;
+    }
+    if (mDecoder.inFrame()) {
+      return toProcessState(mDecoder.feed(newByteIn));
+    }
+    if (mSequencedDecoder.inFrame()) {
+      return toSequencedState(mSequencedDecoder.feed(newByteIn));
+    }
+    if (mBatchDecoder.inFrame()) {
+      return toBatchState(mBatchDecoder.feed(newByteIn));
+    }
+    mDecoder.feed(newByteIn);
+    mSequencedDecoder.feed(newByteIn);
+    mBatchDecoder.feed(newByteIn);
+    return WdInputMessageProcessState::InputMessageIncomplete;
+  }
+
+  // All decoders wait for start byte 1
+  bool idle() const {
+    return mDecoder.idle() && mSequencedDecoder.idle() && mBatchDecoder.idle();
+  }
+
+  // A frame of any kind lying wholly in [bytes, end), checked in place.
+  // Returns its size, 0 when it runs past end.
+  size_t frameAt(const uint8_t *bytes, const uint8_t *end,
+                 WdInputMessageProcessState &state) const {
+    const size_t available = end - bytes;
+    if (bytes[1] == WdInputMsg::kInputMsgStartByte2) {
+      const size_t size = WdInputMsg::Frame::frameAt(bytes, available);
+      if (size != 0) {
+        state = toProcessState(WdInputMsg::Frame::check(bytes, size));
+      }
+      return size;
+    }
+    if (bytes[1] == WdInputMsg::kSequencedMsgStartByte2) {
+      const size_t size =
+          WdInputMsg::SequencedFrame::frameAt(bytes, available);
+      if (size != 0) {
+        state =
+            toSequencedState(WdInputMsg::SequencedFrame::check(bytes, size));
+      }
+      return size;
+    }
+    const size_t size = WdInputMsg::BatchFrame::frameAt(bytes, available);
+    if (size != 0) {
+      state = toBatchState(WdInputMsg::BatchFrame::check(bytes, size));
+    }
+    return size;
+  }
+
+  // Bulk decoding of all frame kinds, as wd_detail::feedBuffer() with
+  // one scan for 'W' followed by 'C', 'S' or 'B'. onFrame(state, frame) is
+  // called for every complete frame, parsing stops after one when it
+  // returns false.
+  // Returns the position after the last byte used.
+  template <typename OnFrame>
+  const uint8_t *parse(const uint8_t *bytes, const uint8_t *end,
+                       OnFrame onFrame) {
+    while (bytes < end) {
+      WdInputMessageProcessState state;
+      const uint8_t *frame;
+      if (mDecoder.inFrame()) {
+        state = toProcessState(mDecoder.feedRest(bytes, end));
+        frame = mDecoder.frame();
+      } else if (mSequencedDecoder.inFrame()) {
+        state = toSequencedState(mSequencedDecoder.feedRest(bytes, end));
+        frame = mSequencedDecoder.frame();
+      } else if (mBatchDecoder.inFrame()) {
+        state = toBatchState(mBatchDecoder.feedRest(bytes, end));
+        frame = mBatchDecoder.frame();
+      } else if (idle()) {
+        const uint8_t *start = wdFindSyncPattern(
+            bytes, end, WdInputMsg::kInputMsgStartByte1,
+            WdInputMsg::kInputMsgStartByte2,
+            WdInputMsg::kSequencedMsgStartByte2,
+            WdInputMsg::kBatchMsgStartByte2);
+        if (start == end) {
+          // A start byte at the end may begin a frame in the next buffer
+          if (end[-1] == WdInputMsg::kInputMsgStartByte1) {
+            stepByte(end[-1]);
+          }
+          return end;
+        }
+        bytes = start;
+        const size_t size = frameAt(bytes, end, state);
+        if (size == 0) {
+          // A frame running past end
+          stepByte(*bytes++);
+          continue;
+        }
+        frame = bytes;
+        bytes += size;
+      } else {
+        // Start bytes and length of a frame
+        stepByte(*bytes++);
+        continue;
+      }
+      if (state != WdInputMessageProcessState::InputMessageIncomplete &&
+          !onFrame(state, frame)) {
+        break;
+      }
+    }
+    return bytes;
+  }
+
+  bool timedOut(ulong currentTimeMs) const {
+    return !idle() &&
+           (currentTimeMs - mLastReceivedTime > kMsgTimeoutThresholdMs);
+  }
+
+  // Timeout check once per buffer, a timeout drops the partial frame and
+  // the buffer is parsed as new data
+  void startBuffer(ulong currentTimeMs) {
+    if (timedOut(currentTimeMs)) {
+      resetStateMachine();
+    }
+    mLastReceivedTime = currentTimeMs;
+  }
 
   // Reset the state machine and input message
   void resetStateMachine() {
-    mCurrentState = WdInputProcessState::WaitForStartByte1;
-    // Reset the input message
+    mDecoder.reset();
+    mSequencedDecoder.reset();
+    mBatchDecoder.reset();
   }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -4,20 +4,134 @@
 #include "WdController.hpp"
 #include "WdInput.hpp"
 #include "WdInputByteProcessor.hpp"
+#include "WdRequestQueue.hpp"
 #include "WdResponse.hpp"
 #include <stdint.h>
 
 class WdManager {
 
 private:
+  static constexpr size_t kRequestQueueSize = 4; // Requests waiting
+
   WdInputMsg mWdInputMsg{};
   WdInputByteProcessor mWdInputByteProcessor;
+  WdRequestQueue<kRequestQueueSize> mRequests;
   ulong currentTimeMs;
 
+  // Last completed batch frame, copied out of the byte processor
+  uint8_t mBatchFrame[WdInputMsg::BatchFrame::kMaxFrameSize];
+  bool mBatchWaiting; // Batch not taken by getBatch() yet
+
+  // Keep the batch the byte processor just completed, false while the
+  // previous one is waiting
+  bool storeBatch() {
+    if (mBatchWaiting) {
+      return false;
+    }
+    const WdInputBatchView batch = mWdInputByteProcessor.getBatch();
+    for (size_t i = 0; i < batch.size(); ++i) {
+      mBatchFrame[i] = batch.data()[i];
+    }
+    mBatchWaiting = true;
+    return true;
+  }
+
 public:
-  WdManager() : mWdInputMsg{}, mWdInputByteProcessor{mWdInputMsg} {}
+  // Response to a batch frame, status byte i answers command i
+  using BatchResponse = WdResponse<WdInputMsg::kMaxBatchCommands>;
+
+  WdManager()
+      : mWdInputMsg{}, mWdInputByteProcessor{mWdInputMsg}, mRequests{},
+        currentTimeMs{0}, mBatchFrame{}, mBatchWaiting{false} {}
+
+  // Outcome of a received byte
+  enum class WdByteResult : uint8_t {
+    Incomplete = 0,     // No frame completed, or one with a bad CRC
+    RequestQueued = 1,  // A request waits for nextRequest()
+    BatchWaiting = 2,   // A batch waits for getBatch()
+    RequestDropped = 3, // Queue full, see droppedRequest()
+    BatchDropped = 4    // The previous batch is still waiting
+  };
+
+  // Process a received byte. A dropped frame is best answered at once
+  // with WdAck::NotAcknowledged, so the host need not wait for its
+  // timeout: sendResponse(out, droppedRequest(), response) for a request,
+  // sendResponse(out, WdRequest{}, BatchResponse{}) for a batch.
+  WdByteResult processMsgByte(const uint8_t newByteIn) {
+    currentTimeMs = millis();
+    const WdInputByteProcessor::WdInputMessageProcessState state =
+        mWdInputByteProcessor.processByte(newByteIn, currentTimeMs);
+    if (state == WdInputByteProcessor::WdInputMessageProcessState::
+                     InputMessageComplete ||
+        state == WdInputByteProcessor::WdInputMessageProcessState::
+                     InputSequencedComplete) {
+      return mRequests.push(mWdInputMsg) ? WdByteResult::RequestQueued
+                                         : WdByteResult::RequestDropped;
+    }
+    if (state == WdInputByteProcessor::WdInputMessageProcessState::
+                     InputBatchComplete) {
+      return storeBatch() ? WdByteResult::BatchWaiting
+                          : WdByteResult::BatchDropped;
+    }
+    return WdByteResult::Incomplete;
+  }
+
+  // The request of the last RequestDropped, with its sequence number
+  WdRequest droppedRequest() const {
+    WdRequest request;
+    request.mCmd = mWdInputMsg.getCmd();
+    request.mSequence = mWdInputMsg.getSequence();
+    request.mSequenced = mWdInputMsg.isSequenced();
+    return request;
+  }
+
+  // Take the oldest queued request, false when none is waiting
+  bool nextRequest(WdRequest &request) { return mRequests.pop(request); }
+
+  // Take the waiting batch, false when none is waiting. The view points
+  // into the manager and stays valid until the next batch completes.
+  bool getBatch(WdInputBatchView &batch) {
+    if (!mBatchWaiting) {
+      return false;
+    }
+    batch = WdInputBatchView{mBatchFrame, sizeof(mBatchFrame)};
+    mBatchWaiting = false;
+    return true;
+  }
+
+  // Write the response to request to out, e.g. Serial. A sequenced
+  // request gets the sequenced response echoing its sequence number.
+  template <typename Output, size_t StatusSize>
+  static void sendResponse(Output &out, const WdRequest &request,
+                           const WdResponse<StatusSize> &response) {
+    if (request.mSequenced) {
+      const auto &raw = response.getRawMsg(request.mSequence);
+      out.write(raw.data(), raw.max_size());
+    } else {
+      const auto &raw = response.getRawMsg();
+      out.write(raw.data(), raw.max_size());
+    }
+  }
 
-  bool processMsgByte(const uint8_t newByteIn) { currentTimeMs = millis(); }
+  // Write the response to batch to out. status(cmd, value, length)
+  // returns the BatchResponse::WdStatus of each command; status bytes
+  // after the last command stay Disabled. A batch whose commands do not
+  // fill its payload is not acknowledged.
+  template <typename Output, typename Status>
+  static void sendBatchResponse(Output &out, const WdInputBatchView &batch,
+                                Status status) {
+    BatchResponse response;
+    if (batch.wellFormed()) {
+      response.setWdAck(BatchResponse::WdAck::Acknowledged);
+    }
+    batch.forEachCommand([&](size_t index, uint8_t cmd, const uint8_t *value,
+                             uint8_t length) {
+      response.setWdStatus(status(cmd, value, length),
+                           static_cast<uint8_t>(index));
+    });
+    const auto &raw = response.getRawMsg();
+    out.write(raw.data(), raw.max_size());
+  }
 };
 
-#endif
\ No newline at end of file
+#endif
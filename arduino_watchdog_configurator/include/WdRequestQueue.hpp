@@ -0,0 +1,66 @@
+#ifndef WD_REQUEST_QUEUE_HPP
+#define WD_REQUEST_QUEUE_HPP
+
+#include "WdInput.hpp"
+#include <stddef.h>
+#include <stdint.h>
+
+// Request of a complete input frame, waiting for its answer
+struct WdRequest {
+  uint8_t mCmd;      // Command byte
+  uint8_t mSequence; // Sequence number to echo, when mSequenced
+  bool mSequenced;   // Answer with a sequenced response
+};
+
+// Fixed size FIFO of parsed requests. With sequenced input frames the
+// host sends further requests before the first is answered; they wait
+// here and each response echoes the sequence number of its request.
+template <size_t Capacity> class WdRequestQueue {
+private:
+  static_assert(Capacity > 0 && Capacity < 256,
+                "The queue counts its requests in a uint8_t");
+
+  WdRequest mRequests[Capacity]; // Ring buffer
+  uint8_t mHead;                 // Oldest request
+  uint8_t mCount;                // Requests waiting
+
+public:
+  WdRequestQueue() : mRequests{}, mHead{0}, mCount{0} {}
+
+  // Append the request of a decoded input message, false when full
+  bool push(const WdInputMsg &wdInputMsg) {
+    if (full()) {
+      return false;
+    }
+    WdRequest &request = mRequests[(mHead + mCount) % Capacity];
+    request.mCmd = wdInputMsg.getCmd();
+    request.mSequence = wdInputMsg.getSequence();
+    request.mSequenced = wdInputMsg.isSequenced();
+    mCount++;
+    return true;
+  }
+
+  // Take the oldest request, false when none is waiting
+  bool pop(WdRequest &request) {
+    if (empty()) {
+      return false;
+    }
+    request = mRequests[mHead];
+    mHead = static_cast<uint8_t>((mHead + 1) % Capacity);
+    mCount--;
+    return true;
+  }
+
+  void clear() {
+    mHead = 0;
+    mCount = 0;
+  }
+
+  size_t size() const { return mCount; }
+
+  bool empty() const { return mCount == 0; }
+
+  bool full() const { return mCount == Capacity; }
+};
+
+#endif // WD_REQUEST_QUEUE_HPP
@@ -2,15 +2,11 @@
 #define WD_RESPONSE_HPP
 
 #include "../array/Array/Array.h"
-#include "../crc/CRC.h"
+#include "WdFrameView.hpp"
 #include <stdint.h>
 
 template <size_t StatusSize = 1> class WdResponse {
 private:
-  // Start bytes for the response
-  static constexpr uint8_t kResponseStartByte1 = 'W'; // Response start byte 1
-  static constexpr uint8_t kResponseStartByte2 = 'R'; // Response start byte 2
-
   static constexpr uint8_t kDisabledByte = 0x00;      // Watchdog is disabled
   static constexpr uint8_t kEnabledByte = 0x01;       // Watchdog is enabled
   static constexpr uint8_t kPinWriteErrorByte = 0x02; // Failed to write to pin
@@ -19,36 +15,64 @@ private:
   static constexpr uint8_t kInvalidCrcByte = 0x08;   // CRC validation failed
   static constexpr uint8_t kTimeoutErrorByte = 0x10; // Message timeout occurred
 
+public:
+  // Frame layout: start bytes, ack, status bytes, CRC16, see
+  // WdFrameView.hpp
+  using Frame = WdResponseFrame<StatusSize>;
+  using View = WdResponseView<StatusSize>;
+  static constexpr size_t kAckField = View::kAckField;
+  static constexpr size_t kStatusField = View::kStatusField;
+
+  // Layout answering a sequenced request: start bytes, sequence, ack,
+  // status bytes, CRC16
+  using SequencedFrame = WdSequencedResponseFrame<StatusSize>;
+  using SequencedView = WdSequencedResponseView<StatusSize>;
+
+private:
   // Size of the raw message
-  static constexpr size_t kRawMsgSize =
-      sizeof(kResponseStartByte1) + sizeof(kResponseStartByte2) + 1 +
-      StatusSize + 2; // Start bytes, Ack, Status bytes, CRC
+  static constexpr size_t kRawMsgSize = Frame::kFrameSize;
 
   using RawResponseArray = Array<uint8_t, kRawMsgSize>;
 
   // Raw response message array
   mutable RawResponseArray mResponseRawMsg = {};
 
-  // Fill the raw message array and calculate CRC16
-  void fillRawResponseMsg() const {
-    uint8_t index = 0;
+  // Size of the raw message echoing a sequence number
+  static constexpr size_t kSequencedRawMsgSize = SequencedFrame::kFrameSize;
+
+  using SequencedRawResponseArray = Array<uint8_t, kSequencedRawMsgSize>;
 
-    // Fill message array
-    mResponseRawMsg[index++] = kResponseStartByte1;
-    mResponseRawMsg[index++] = kResponseStartByte2;
-    mResponseRawMsg[index++] = mAck;
+  // Raw response message array with sequence number
+  mutable SequencedRawResponseArray mSequencedResponseRawMsg = {};
 
-    // Copy status bytes
+  // Copy status bytes
+  void copyStatus(uint8_t *status) const {
     for (size_t i = 0; i < StatusSize; ++i) {
-      mResponseRawMsg[index++] = mStatus[i];
+      status[i] = mStatus[i];
     }
+  }
 
-    // Calculate CRC16 for the message up to the status bytes
-    uint16_t crc16 = calcCRC16(mResponseRawMsg.data(), kRawMsgSize - 2);
+  // Fill the raw message array and calculate CRC16
+  void fillRawResponseMsg() const {
+    uint8_t *raw = mResponseRawMsg.data();
+    *Frame::template field<kAckField>(raw) = mAck;
+    copyStatus(Frame::template field<kStatusField>(raw));
 
-    // Set CRC16 bytes in the raw message
-    mResponseRawMsg[index++] = static_cast<uint8_t>((crc16 >> 8) & 0x00FF);
-    mResponseRawMsg[index++] = static_cast<uint8_t>(crc16 & 0x00FF);
+    // Start bytes and CRC16
+    Frame::seal(raw);
+  }
+
+  // Fill the sequenced raw message array and calculate CRC16
+  void fillSequencedRawResponseMsg(uint8_t sequence) const {
+    uint8_t *raw = mSequencedResponseRawMsg.data();
+    *SequencedFrame::template field<SequencedView::kSequenceField>(raw) =
+        sequence;
+    *SequencedFrame::template field<SequencedView::kAckField>(raw) = mAck;
+    copyStatus(
+        SequencedFrame::template field<SequencedView::kStatusField>(raw));
+
+    // Start bytes and CRC16
+    SequencedFrame::seal(raw);
   }
 
 public:
@@ -92,6 +116,13 @@ public:
     return mResponseRawMsg;
   }
 
+  // Method to get raw message array answering the request with sequence
+  // number sequence (with calculated CRC16)
+  const SequencedRawResponseArray &getRawMsg(uint8_t sequence) const {
+    fillSequencedRawResponseMsg(sequence);
+    return mSequencedResponseRawMsg;
+  }
+
   bool setWdAck(WdAck wDAckIn) {
     mAck = static_cast<uint8_t>(wDAckIn);
     return true; // Always successful
@@ -0,0 +1,246 @@
+#ifndef WD_SYNC_SCANNER_HPP
+#define WD_SYNC_SCANNER_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Two byte sync pattern search, e.g. 'W' 'C' input frames and 'W' 'R'
+// responses in a capture. The search runs memchr() for the first byte,
+// fastest while first bytes are rare. On x86 hosts a run of false
+// candidates, first bytes not followed by a second byte, switches to
+// comparing 64 (AVX2) or 32 (SSE2) bytes per step: one movemask gives
+// the first byte positions, one the second byte positions, shifted by
+// one they give the pairs.
+// wdScanSyncPattern() reports every match, e.g. as frame candidates for
+// WdInputByteProcessor::processBytes().
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) &&      \
+    !defined(ARDUINO)
+#define WD_SYNC_SCANNER_X86 1
+#include <immintrin.h>
+#endif
+
+namespace wd_detail {
+
+// First position in [bytes, end - 1) of first followed by second1,
+// second2 or second3, or end
+inline const uint8_t *findSyncScalar(const uint8_t *bytes, const uint8_t *end,
+                                     uint8_t first, uint8_t second1,
+                                     uint8_t second2, uint8_t second3) {
+  while (end - bytes >= 2) {
+    const uint8_t *candidate = static_cast<const uint8_t *>(
+        memchr(bytes, first, end - bytes - 1));
+    if (candidate == nullptr) {
+      break;
+    }
+    if (candidate[1] == second1 || candidate[1] == second2 ||
+        candidate[1] == second3) {
+      return candidate;
+    }
+    bytes = candidate + 1;
+  }
+  return end;
+}
+
+#if defined(WD_SYNC_SCANNER_X86)
+
+// Pair positions from the first byte and second byte masks of n bytes,
+// bit n - 1 pairs with the byte after them, next
+inline uint64_t syncPairs(uint64_t firstMask, uint64_t secondMask, uint8_t n,
+                          uint8_t next, uint8_t second1, uint8_t second2,
+                          uint8_t second3) {
+  const uint64_t carry =
+      (next == second1 || next == second2 || next == second3) ? 1 : 0;
+  return firstMask & ((secondMask >> 1) | (carry << (n - 1)));
+}
+
+__attribute__((target("sse2"))) inline const uint8_t *
+findSyncSse2(const uint8_t *bytes, const uint8_t *end, uint8_t first,
+             uint8_t second1, uint8_t second2, uint8_t second3) {
+  const __m128i v1 = _mm_set1_epi8(static_cast<char>(first));
+  const __m128i v2a = _mm_set1_epi8(static_cast<char>(second1));
+  const __m128i v2b = _mm_set1_epi8(static_cast<char>(second2));
+  const __m128i v2c = _mm_set1_epi8(static_cast<char>(second3));
+  // 32 positions per step, the byte after them is read for the last one
+  while (end - bytes > 32) {
+    const __m128i a0 =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes));
+    const __m128i a1 =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + 16));
+    const __m128i f0 = _mm_cmpeq_epi8(a0, v1);
+    const __m128i f1 = _mm_cmpeq_epi8(a1, v1);
+    // Most steps hold no first byte at all
+    if (_mm_movemask_epi8(_mm_or_si128(f0, f1)) != 0) {
+      const uint64_t firstMask =
+          static_cast<uint32_t>(_mm_movemask_epi8(f0)) |
+          (static_cast<uint32_t>(_mm_movemask_epi8(f1)) << 16);
+      const __m128i s0 =
+          _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(a0, v2a),
+                                    _mm_cmpeq_epi8(a0, v2b)),
+                       _mm_cmpeq_epi8(a0, v2c));
+      const __m128i s1 =
+          _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(a1, v2a),
+                                    _mm_cmpeq_epi8(a1, v2b)),
+                       _mm_cmpeq_epi8(a1, v2c));
+      const uint64_t secondMask =
+          static_cast<uint32_t>(_mm_movemask_epi8(s0)) |
+          (static_cast<uint32_t>(_mm_movemask_epi8(s1)) << 16);
+      const uint64_t pairs = syncPairs(firstMask, secondMask, 32, bytes[32],
+                                       second1, second2, second3);
+      if (pairs != 0) {
+        return bytes + __builtin_ctzll(pairs);
+      }
+    }
+    bytes += 32;
+  }
+  return findSyncScalar(bytes, end, first, second1, second2, second3);
+}
+
+__attribute__((target("avx2"))) inline const uint8_t *
+findSyncAvx2(const uint8_t *bytes, const uint8_t *end, uint8_t first,
+             uint8_t second1, uint8_t second2, uint8_t second3) {
+  const __m256i v1 = _mm256_set1_epi8(static_cast<char>(first));
+  const __m256i v2a = _mm256_set1_epi8(static_cast<char>(second1));
+  const __m256i v2b = _mm256_set1_epi8(static_cast<char>(second2));
+  const __m256i v2c = _mm256_set1_epi8(static_cast<char>(second3));
+  // 64 positions per step, the byte after them is read for the last one
+  while (end - bytes > 64) {
+    const __m256i a0 =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bytes));
+    const __m256i a1 =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bytes + 32));
+    const __m256i f0 = _mm256_cmpeq_epi8(a0, v1);
+    const __m256i f1 = _mm256_cmpeq_epi8(a1, v1);
+    // Most steps hold no first byte at all
+    const __m256i any = _mm256_or_si256(f0, f1);
+    if (!_mm256_testz_si256(any, any)) {
+      const uint64_t firstMask =
+          static_cast<uint32_t>(_mm256_movemask_epi8(f0)) |
+          (static_cast<uint64_t>(
+               static_cast<uint32_t>(_mm256_movemask_epi8(f1)))
+           << 32);
+      const __m256i s0 =
+          _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(a0, v2a),
+                                          _mm256_cmpeq_epi8(a0, v2b)),
+                          _mm256_cmpeq_epi8(a0, v2c));
+      const __m256i s1 =
+          _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(a1, v2a),
+                                          _mm256_cmpeq_epi8(a1, v2b)),
+                          _mm256_cmpeq_epi8(a1, v2c));
+      const uint64_t secondMask =
+          static_cast<uint32_t>(_mm256_movemask_epi8(s0)) |
+          (static_cast<uint64_t>(
+               static_cast<uint32_t>(_mm256_movemask_epi8(s1)))
+           << 32);
+      const uint64_t pairs = syncPairs(firstMask, secondMask, 64, bytes[64],
+                                       second1, second2, second3);
+      if (pairs != 0) {
+        return bytes + __builtin_ctzll(pairs);
+      }
+    }
+    bytes += 64;
+  }
+  return findSyncSse2(bytes, end, first, second1, second2, second3);
+}
+
+inline bool syncAvx2Supported() {
+  static const bool supported = __builtin_cpu_supports("avx2");
+  return supported;
+}
+
+#endif
+
+typedef const uint8_t *(*FindSync)(const uint8_t *bytes, const uint8_t *end,
+                                   uint8_t first, uint8_t second1,
+                                   uint8_t second2, uint8_t second3);
+
+// memchr() beats the pair masks while first bytes are rare, e.g. frame
+// starts in sparse garbage. Once kDenseMisses false candidates come less
+// than kDenseSpacing bytes apart on average, dense takes the rest.
+constexpr unsigned kDenseMisses = 4;
+constexpr size_t kDenseSpacing = 64;
+
+inline const uint8_t *findSyncAdaptive(const uint8_t *bytes,
+                                       const uint8_t *end, uint8_t first,
+                                       uint8_t second1, uint8_t second2,
+                                       uint8_t second3, FindSync dense) {
+  const uint8_t *window = bytes;
+  unsigned misses = 0;
+  while (end - bytes >= 2) {
+    const uint8_t *candidate = static_cast<const uint8_t *>(
+        memchr(bytes, first, end - bytes - 1));
+    if (candidate == nullptr) {
+      break;
+    }
+    if (candidate[1] == second1 || candidate[1] == second2 ||
+        candidate[1] == second3) {
+      return candidate;
+    }
+    bytes = candidate + 1;
+    if (++misses == kDenseMisses) {
+      if (static_cast<size_t>(bytes - window) < kDenseMisses * kDenseSpacing) {
+        return dense(bytes, end, first, second1, second2, second3);
+      }
+      window = bytes;
+      misses = 0;
+    }
+  }
+  return end;
+}
+
+} // namespace wd_detail
+
+// First position in [bytes, end) where first is followed by second1,
+// second2 or second3, end when there is none. A first byte in the last
+// position is not reported, its second byte is still to come.
+inline const uint8_t *wdFindSyncPattern(const uint8_t *bytes,
+                                        const uint8_t *end, uint8_t first,
+                                        uint8_t second1, uint8_t second2,
+                                        uint8_t second3) {
+#if defined(WD_SYNC_SCANNER_X86)
+  if (wd_detail::syncAvx2Supported()) {
+    return wd_detail::findSyncAdaptive(bytes, end, first, second1, second2,
+                                       second3, wd_detail::findSyncAvx2);
+  }
+#endif
+#if defined(WD_SYNC_SCANNER_X86) && defined(__SSE2__)
+  return wd_detail::findSyncAdaptive(bytes, end, first, second1, second2,
+                                     second3, wd_detail::findSyncSse2);
+#else
+  return wd_detail::findSyncScalar(bytes, end, first, second1, second2,
+                                   second3);
+#endif
+}
+
+// First position of first followed by second1 or second2
+inline const uint8_t *wdFindSyncPattern(const uint8_t *bytes,
+                                        const uint8_t *end, uint8_t first,
+                                        uint8_t second1, uint8_t second2) {
+  return wdFindSyncPattern(bytes, end, first, second1, second2, second2);
+}
+
+// First position of first followed by second, e.g. 'W' 'C'
+inline const uint8_t *wdFindSyncPattern(const uint8_t *bytes,
+                                        const uint8_t *end, uint8_t first,
+                                        uint8_t second) {
+  return wdFindSyncPattern(bytes, end, first, second, second, second);
+}
+
+// Calls onMatch(offset) for every position of first followed by second1
+// or second2 in bytes, returns the number of matches
+template <typename OnMatch>
+size_t wdScanSyncPattern(const uint8_t *bytes, size_t length, uint8_t first,
+                         uint8_t second1, uint8_t second2, OnMatch onMatch) {
+  const uint8_t *const end = bytes + length;
+  size_t matches = 0;
+  const uint8_t *at = bytes;
+  while ((at = wdFindSyncPattern(at, end, first, second1, second2)) != end) {
+    onMatch(static_cast<size_t>(at - bytes));
+    matches++;
+    at++;
+  }
+  return matches;
+}
+
+#endif // WD_SYNC_SCANNER_HPP
@@ -6,19 +6,11 @@
 
 
 #include "FastCRC32.h"
+#include "CrcTable.h"
 
 
 namespace
 {
-// Conditionally use pgm memory if it is available.
-#if defined(PROGMEM)
-    #define FLASH_PROGMEM PROGMEM
-    #define FLASH_READ_DWORD(x) (pgm_read_dword_near(x))
-#else
-    #define FLASH_PROGMEM
-    #define FLASH_READ_DWORD(x) (*(uint32_t*)(x))
-#endif
-
 static const uint32_t crc32LookupTable[] FLASH_PROGMEM = {
     0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac,
     0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
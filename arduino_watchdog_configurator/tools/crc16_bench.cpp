@@ -0,0 +1,100 @@
+//
+//    FILE: crc16_bench.cpp
+// PURPOSE: host benchmark, bitwise CRC16 versus NibbleCRC16 and TableCRC16
+//
+//  build and run with: make bench
+
+
+#include "CRC16.h"
+#include "NibbleCRC16.h"
+#include "TableCRC16.h"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+
+namespace
+{
+uint64_t cycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  //  no cycle counter, report nanoseconds instead
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+           std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+volatile uint16_t sink;
+
+template <typename Engine>
+double cyclesPerByte(Engine &crc, const std::vector<uint8_t> &buffer, size_t rounds)
+{
+  uint64_t start = cycles();
+  for (size_t r = 0; r < rounds; r++)
+  {
+    crc.restart();
+    crc.add(buffer.data(), buffer.size());
+    sink = crc.calc();
+  }
+  return (double)(cycles() - start) / ((double)buffer.size() * rounds);
+}
+
+template <uint16_t polynome, bool reverseIn>
+void compare(const char *name, uint16_t initial, uint16_t xorOut, bool reverseOut)
+{
+  //  3 bytes is the checksummed part of a WdInputMsg
+  static const size_t sizes[] = { 3, 5, 64, 4096 };
+
+  CRC16 bitwise(polynome, initial, xorOut, reverseIn, reverseOut);
+  NibbleCRC16<polynome, reverseIn> nibble(initial, xorOut, reverseOut);
+  TableCRC16<polynome, reverseIn> table(initial, xorOut, reverseOut);
+
+  for (size_t size : sizes)
+  {
+    std::vector<uint8_t> buffer(size);
+    for (size_t i = 0; i < size; i++) buffer[i] = (uint8_t)(i * 31 + 7);
+
+    size_t rounds = (64u << 20) / size;
+    double bitwiseCpb = cyclesPerByte(bitwise, buffer, rounds);
+    double nibbleCpb = cyclesPerByte(nibble, buffer, rounds);
+    double tableCpb = cyclesPerByte(table, buffer, rounds);
+    if (bitwise.calc() != nibble.calc() || bitwise.calc() != table.calc())
+    {
+      printf("%-18s %6zu  MISMATCH %04X %04X %04X\n", name, size, bitwise.calc(), nibble.calc(), table.calc());
+      continue;
+    }
+    printf("%-18s %6zu %10.2f %11.2f %10.2f %8.1fx\n", name, size, bitwiseCpb, nibbleCpb, tableCpb, bitwiseCpb / tableCpb);
+  }
+}
+}
+
+
+int main()
+{
+  printf("%-18s %6s %10s %11s %10s %9s\n", "preset", "bytes", "CRC16", "NibbleCRC16", "TableCRC16", "speedup");
+  printf("(cycles/byte%s)\n",
+#if defined(__x86_64__) || defined(__i386__)
+         ""
+#else
+         ", measured in ns"
+#endif
+        );
+
+  compare<CRC16_POLYNOME, CRC16_REV_IN>("CRC16", CRC16_INITIAL, CRC16_XOR_OUT, CRC16_REV_OUT);
+  compare<CRC16_CCITT_FALSE_POLYNOME, CRC16_CCITT_FALSE_REV_IN>("CRC16_CCITT_FALSE",
+    CRC16_CCITT_FALSE_INITIAL, CRC16_CCITT_FALSE_XOR_OUT, CRC16_CCITT_FALSE_REV_OUT);
+  compare<CRC16_MODBUS_POLYNOME, CRC16_MODBUS_REV_IN>("CRC16_MODBUS",
+    CRC16_MODBUS_INITIAL, CRC16_MODBUS_XOR_OUT, CRC16_MODBUS_REV_OUT);
+  return 0;
+}
+
+
+//  -- END OF FILE --
+
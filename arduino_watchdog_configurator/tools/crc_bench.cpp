@@ -0,0 +1,238 @@
+//
+//    FILE: crc_bench.cpp
+// PURPOSE: host benchmark of every CRC engine over every preset, JSON output
+//
+//  usage: crc_bench [-m maxBytes] [-t minMs] [-f filter] > results.json
+//
+//  Measures the CRC8 .. CRC64 classes, the calcCRC*() functions,
+//  FastCRC32, CRC32C and the Crc<> policies (CrcPolicy.h) for all
+//  complete presets, as listed by CRC_REGISTRY_PRESETS (CrcRegistry.h).
+//  Buffer sizes run from 3 bytes (a WdInputMsg) to maxBytes, default 1M,
+//  up to 1G: the bitwise engines need seconds per preset for the large
+//  sizes.
+//  Every result is one JSON object with ns per call, cycles per byte
+//  and GB/s; progress goes to stderr.
+//
+//  build and run with: make bench-json
+
+
+#include "CRC.h"
+#include "CRC32C.h"
+#include "FastCRC32.h"
+#include "CrcRegistry.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+
+namespace
+{
+typedef uint64_t (*RunFunction)(const uint8_t *array, size_t length);
+
+struct Engine
+{
+  const char *engine;
+  const char *preset;
+  uint8_t width;
+  RunFunction run;
+};
+
+uint64_t cycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  //  no cycle counter, report nanoseconds instead
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+           std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+
+//  the run time parameterized classes
+template <typename Class, typename Preset>
+uint64_t runClass(const uint8_t *array, size_t length)
+{
+  Class crc(Preset::getPolynome(), Preset::getInitial(), Preset::getXorOut(),
+            Preset::getReverseIn(), Preset::getReverseOut());
+  crc.add(array, length);
+  return crc.calc();
+}
+
+#define CRC_BENCH_CALC(width) \
+  template <typename Preset> \
+  uint64_t runCalc##width(const uint8_t *array, size_t length) \
+  { \
+    return calcCRC##width(array, length, Preset::getPolynome(), Preset::getInitial(), \
+                          Preset::getXorOut(), Preset::getReverseIn(), Preset::getReverseOut()); \
+  }
+CRC_BENCH_CALC(8)
+CRC_BENCH_CALC(12)
+CRC_BENCH_CALC(16)
+CRC_BENCH_CALC(32)
+CRC_BENCH_CALC(64)
+#undef CRC_BENCH_CALC
+
+template <typename Preset>
+uint64_t runPolicy(const uint8_t *array, size_t length)
+{
+  return Preset::compute(array, length);
+}
+
+template <typename Fixed>
+uint64_t runFixed(const uint8_t *array, size_t length)
+{
+  Fixed crc;
+  crc.add(array, length);
+  return crc.calc();
+}
+
+
+#define CRC_BENCH_COMMON(width, name) \
+  { "CRC" #width, #name, width, &runClass<CRC##width, CRC_PRESET(width, name)> }, \
+  { "calcCRC" #width, #name, width, &runCalc##width<CRC_PRESET(width, name)> }, \
+  { "Crc<nibble>", #name, width, &runPolicy<CRC_PRESET_POLICY(width, name, CrcNibblePolicy)> }, \
+  { "Crc<byte>", #name, width, &runPolicy<CRC_PRESET_POLICY(width, name, CrcBytePolicy)> },
+#define CRC_BENCH_HARDWARE(width, name) \
+  { "Crc<hardware>", #name, width, &runPolicy<CRC_PRESET_POLICY(width, name, CrcHardwarePolicy)> },
+#define CRC_BENCH_SLICING(width, name) \
+  { "Crc<slicing8>", #name, width, &runPolicy<CRC_PRESET_POLICY(width, name, CrcSlicingPolicy<8>)> },
+
+#define CRC_BENCH_8(name) CRC_BENCH_COMMON(8, name)
+#define CRC_BENCH_12(name) CRC_BENCH_COMMON(12, name)
+#define CRC_BENCH_16(name) CRC_BENCH_COMMON(16, name) CRC_BENCH_HARDWARE(16, name)
+#define CRC_BENCH_32(name) CRC_BENCH_COMMON(32, name) CRC_BENCH_SLICING(32, name) CRC_BENCH_HARDWARE(32, name)
+#define CRC_BENCH_64(name) CRC_BENCH_COMMON(64, name) CRC_BENCH_SLICING(64, name) CRC_BENCH_HARDWARE(64, name)
+#define PRESET(width, name, check) CRC_BENCH_##width(name)
+
+const Engine engines[] =
+{
+  CRC_REGISTRY_PRESETS
+  { "FastCRC32", "CRC32", 32, &runFixed<FastCRC32> },
+  { "CRC32C", "CRC32_CASTAGNOLI", 32, &runFixed<CRC32C> },
+};
+
+#undef PRESET
+
+
+volatile uint64_t sink;
+
+//  Runs engine over size bytes until minSeconds passed, at least once.
+void measure(const Engine &engine, const uint8_t *buffer, size_t size, double minSeconds, bool &first)
+{
+  size_t calls = 0;
+  uint64_t startCycles = cycles();
+  auto start = std::chrono::steady_clock::now();
+  double seconds = 0;
+  do
+  {
+    //  batches keep the clock reads out of the small size results
+    size_t batch = size < 4096 ? 4096 / size : 1;
+    for (size_t i = 0; i < batch; i++)
+    {
+      sink = engine.run(buffer, size);
+    }
+    calls += batch;
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+  while (seconds < minSeconds);
+  uint64_t elapsedCycles = cycles() - startCycles;
+
+  double bytes = (double)size * calls;
+  printf("%s\n  {\"engine\": \"%s\", \"preset\": \"%s\", \"width\": %u, \"bytes\": %zu, "
+         "\"calls\": %zu, \"ns_per_call\": %.3f, \"cycles_per_byte\": %.3f, \"gb_per_s\": %.4f}",
+         first ? "" : ",", engine.engine, engine.preset, engine.width, size, calls,
+         seconds * 1e9 / calls, elapsedCycles / bytes, bytes / seconds / 1e9);
+  first = false;
+}
+
+size_t parseSize(const char *text)
+{
+  char *end = nullptr;
+  size_t size = strtoull(text, &end, 10);
+  switch (*end)
+  {
+    case 'k': case 'K': return size << 10;
+    case 'm': case 'M': return size << 20;
+    case 'g': case 'G': return size << 30;
+    default: return size;
+  }
+}
+}  // namespace
+
+
+int main(int argc, char *argv[])
+{
+  size_t maxSize = 1 << 20;
+  double minSeconds = 0.02;
+  const char *filter = nullptr;
+
+  int option;
+  while ((option = getopt(argc, argv, "m:t:f:h")) != -1)
+  {
+    switch (option)
+    {
+      case 'm':
+        maxSize = std::max<size_t>(1, parseSize(optarg));
+        break;
+      case 't':
+        minSeconds = atof(optarg) / 1000;
+        break;
+      case 'f':
+        filter = optarg;
+        break;
+      default:
+        fprintf(stderr,
+                "usage: crc_bench [-m maxBytes] [-t minMs] [-f filter] > results.json\n"
+                "  -m  largest buffer, e.g. 64K, 16M, 1G, default 1M\n"
+                "  -t  minimum time per measurement in ms, default 20\n"
+                "  -f  only engines or presets containing filter\n");
+        return 2;
+    }
+  }
+
+  //  3 bytes is the checksummed part of a WdInputMsg, 5 a whole one;
+  //  no size beyond maxSize
+  std::vector<size_t> sizes;
+  for (size_t size : { 3, 5 })
+  {
+    if (size <= maxSize) sizes.push_back(size);
+  }
+  for (size_t size = 16; size <= maxSize; size *= 4) sizes.push_back(size);
+  if (sizes.empty() || sizes.back() != maxSize) sizes.push_back(maxSize);
+
+  std::vector<uint8_t> buffer(sizes.back());
+  for (size_t i = 0; i < buffer.size(); i++) buffer[i] = (uint8_t)(i * 31 + 7);
+
+  printf("[");
+  bool first = true;
+  for (const Engine &engine : engines)
+  {
+    if (filter != nullptr && strstr(engine.engine, filter) == nullptr &&
+        strstr(engine.preset, filter) == nullptr)
+    {
+      continue;
+    }
+    fprintf(stderr, "%s %s\n", engine.engine, engine.preset);
+    for (size_t size : sizes)
+    {
+      measure(engine, buffer.data(), size, minSeconds, first);
+    }
+  }
+  printf("\n]\n");
+  return 0;
+}
+
+
+//  -- END OF FILE --
@@ -0,0 +1,490 @@
+//
+//    FILE: crc_verify.cpp
+// PURPOSE: differential verification of the fast CRC engines
+//
+//  usage: crc_verify [-j threads] [-b megabytes] [-l maxLength] [-s seed]
+//
+//  Every engine must give the same result as the reference bitwise
+//  classes CRC8 .. CRC64 for every complete preset in CrcParameters.h:
+//  - the "123456789" check value of each preset, see CrcRegistry.h,
+//    for the reference classes and every engine;
+//  - the reverse8bits() buffer kernels against the scalar one;
+//  - random messages of random length and alignment, fed to the
+//    streaming engines in random pieces, every other piece with a
+//    yield period from 0 (CRC_YIELD_DISABLED) to 7.
+//  Worker threads draw messages until megabytes of reference data are
+//  checked. A mismatch prints the engine, preset, seed and message
+//  shape, and the exit status is 1.
+//
+//  build and run with: make verify
+
+
+#include "CRC.h"
+#include "CRC32C.h"
+#include "FastCRC32.h"
+#include "CrcBatch.h"
+#include "CrcRegistry.h"
+#include "TableCRC16.h"
+#include "NibbleCRC8.h"
+#include "NibbleCRC12.h"
+#include "NibbleCRC16.h"
+#include "NibbleCRC64.h"
+#include "SlicingCRC32.h"
+#include "SlicingCRC64.h"
+#include "ClmulCRC16.h"
+#include "ClmulCRC32.h"
+#include "ClmulCRC64.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+
+namespace
+{
+//  splits[0 .. splitCount) are increasing offsets where a streaming
+//  engine starts a new add() call
+struct Message
+{
+  const uint8_t *data;
+  size_t length;
+  const size_t *splits;
+  size_t splitCount;
+};
+
+typedef uint64_t (*RunFunction)(const Message &message);
+
+struct Engine
+{
+  const char *engine;
+  RunFunction run;
+};
+
+struct Preset
+{
+  const char *name;
+  uint8_t width;
+  uint64_t check;
+  RunFunction reference;
+  const Engine *engines;
+  size_t engineCount;
+};
+
+
+//  yield period of piece i, 0 is CRC_YIELD_DISABLED
+crc_size_t yieldPeriod(const Message &message, size_t i)
+{
+  return (crc_size_t)((message.length + i) % 8);
+}
+
+//  piece i of a message runs from splits[i - 1] to splits[i],
+//  every other piece goes through add() with a yield period
+template <typename Engine>
+void addPieces(Engine &crc, const Message &message)
+{
+  size_t start = 0;
+  for (size_t i = 0; i <= message.splitCount; i++)
+  {
+    size_t end = i < message.splitCount ? message.splits[i] : message.length;
+    if (i % 2) crc.add(message.data + start, end - start, yieldPeriod(message, i));
+    else crc.add(message.data + start, end - start);
+    start = end;
+  }
+}
+
+template <typename Class, typename Preset>
+uint64_t runClass(const Message &message)
+{
+  Class crc(Preset::getPolynome(), Preset::getInitial(), Preset::getXorOut(),
+            Preset::getReverseIn(), Preset::getReverseOut());
+  addPieces(crc, message);
+  return crc.calc();
+}
+
+//  single byte add() and the yield, time budget and segment variants
+template <typename Class, typename Preset>
+uint64_t runClassMixed(const Message &message)
+{
+  Class crc(Preset::getPolynome(), Preset::getInitial(), Preset::getXorOut(),
+            Preset::getReverseIn(), Preset::getReverseOut());
+  size_t start = 0;
+  for (size_t i = 0; i <= message.splitCount; i++)
+  {
+    size_t end = i < message.splitCount ? message.splits[i] : message.length;
+    const uint8_t *piece = message.data + start;
+    size_t length = end - start;
+    switch (i % 4)
+    {
+      case 0:
+        while (length--) crc.add(*piece++);
+        break;
+      case 1:
+        crc.add(piece, length, yieldPeriod(message, i));
+        break;
+      case 2:
+        crc.addTimed(piece, length, 1);
+        break;
+      default:
+      {
+        CrcSegment segments[2] = { { piece, length / 2 }, { piece + length / 2, length - length / 2 } };
+        crc.add(segments, 2);
+      }
+    }
+    start = end;
+  }
+  return crc.calc();
+}
+
+template <typename Engine, typename Preset>
+uint64_t runTemplate(const Message &message)
+{
+  Engine crc(Preset::getInitial(), Preset::getXorOut(), Preset::getReverseOut());
+  addPieces(crc, message);
+  return crc.calc();
+}
+
+template <typename Preset>
+uint64_t runPolicy(const Message &message)
+{
+  Preset crc;
+  addPieces(crc, message);
+  return crc.calc();
+}
+
+template <typename Fixed>
+uint64_t runFixed(const Message &message)
+{
+  Fixed crc;
+  addPieces(crc, message);
+  return crc.calc();
+}
+
+//  the pieces are checksummed on their own and merged
+template <typename Preset>
+uint64_t runCombine(const Message &message)
+{
+  typename Preset::Type crc = Preset::compute(message.data, 0);
+  size_t start = 0;
+  for (size_t i = 0; i <= message.splitCount; i++)
+  {
+    size_t end = i < message.splitCount ? message.splits[i] : message.length;
+    crc = Preset::combine(crc, Preset::compute(message.data + start, end - start), end - start);
+    start = end;
+  }
+  return crc;
+}
+
+//  33 to 40 frames of the message, frame i with its bytes xored with i,
+//  so a lane or stride mix-up changes a result. Frame 0 is the message,
+//  every other frame must match Preset::compute(). The counts leave a
+//  scalar tail after the 16 lane steps; frames shorter than 4 bytes get a
+//  stride of at least 4, which hands their last frame to the scalar code.
+template <typename Preset>
+uint64_t runBatch(const Message &message)
+{
+  const size_t count = 33 + message.length % 8;
+  const size_t stride = std::max<size_t>(message.length + 1 + message.length % 4, 4);
+  //  nothing after the last frame, as at the end of a receive buffer
+  std::vector<uint8_t> frames((count - 1) * stride + message.length);
+  for (size_t i = 0; i < count; i++)
+  {
+    for (size_t j = 0; j < message.length; j++)
+    {
+      frames[i * stride + j] = (uint8_t)(message.data[j] ^ (i * 0x9D));
+    }
+  }
+  std::vector<typename Preset::Type> results(count);
+  crcBatch<Preset>(frames.data(), count, stride, message.length, results.data());
+  for (size_t i = 1; i < count; i++)
+  {
+    if (results[i] != Preset::compute(frames.data() + i * stride, message.length))
+    {
+      return ~(uint64_t)results[0];
+    }
+  }
+  return results[0];
+}
+
+//  looked up by name, as a gateway would
+uint64_t runRuntime(const char *name, const Message &message)
+{
+  CrcRuntime crc(*crcFindPreset(name));
+  addPieces(crc, message);
+  return crc.calc();
+}
+
+#define CRC_VERIFY_CALC(width) \
+  template <typename Preset> \
+  uint64_t runCalc##width(const Message &message) \
+  { \
+    return calcCRC##width(message.data, message.length, Preset::getPolynome(), Preset::getInitial(), \
+                          Preset::getXorOut(), Preset::getReverseIn(), Preset::getReverseOut()); \
+  }
+CRC_VERIFY_CALC(8)
+CRC_VERIFY_CALC(12)
+CRC_VERIFY_CALC(16)
+CRC_VERIFY_CALC(32)
+CRC_VERIFY_CALC(64)
+#undef CRC_VERIFY_CALC
+
+
+#define P(width, name) CRC_PRESET(width, name)
+#define PP(width, name, policy) CRC_PRESET_POLICY(width, name, policy)
+
+#define CRC_VERIFY_COMMON(width, name) \
+  { "CRC" #width " mixed add", &runClassMixed<CRC##width, P(width, name)> }, \
+  { "calcCRC" #width, &runCalc##width<P(width, name)> }, \
+  { "Crc<bitwise>", &runPolicy<PP(width, name, CrcBitwisePolicy)> }, \
+  { "Crc<nibble>", &runPolicy<PP(width, name, CrcNibblePolicy)> }, \
+  { "Crc<byte>", &runPolicy<P(width, name)> }, \
+  { "Crc<>::combine", &runCombine<P(width, name)> }, \
+  { "crcBatch", &runBatch<P(width, name)> }, \
+  { "CrcRuntime", [](const Message &message) { return runRuntime(#name, message); } },
+#define CRC_VERIFY_NIBBLE(width, name) \
+  { "NibbleCRC" #width, &runTemplate<NibbleCRC##width<name##_POLYNOME, name##_REV_IN>, P(width, name)> },
+#define CRC_VERIFY_CLMUL(width, name) \
+  { "ClmulCRC" #width, &runTemplate<ClmulCRC##width<name##_POLYNOME, name##_REV_IN>, P(width, name)> }, \
+  { "Crc<hardware>", &runPolicy<PP(width, name, CrcHardwarePolicy)> },
+#define CRC_VERIFY_SLICING(width, name) \
+  { "SlicingCRC" #width "<4>", &runTemplate<SlicingCRC##width<4, name##_POLYNOME, name##_REV_IN>, P(width, name)> }, \
+  { "SlicingCRC" #width "<8>", &runTemplate<SlicingCRC##width<8, name##_POLYNOME, name##_REV_IN>, P(width, name)> }, \
+  { "SlicingCRC" #width "<16>", &runTemplate<SlicingCRC##width<16, name##_POLYNOME, name##_REV_IN>, P(width, name)> },
+
+#define CRC_VERIFY_8(name) CRC_VERIFY_COMMON(8, name) CRC_VERIFY_NIBBLE(8, name)
+#define CRC_VERIFY_12(name) CRC_VERIFY_COMMON(12, name) CRC_VERIFY_NIBBLE(12, name)
+#define CRC_VERIFY_16(name) CRC_VERIFY_COMMON(16, name) CRC_VERIFY_NIBBLE(16, name) CRC_VERIFY_CLMUL(16, name) \
+  { "TableCRC16", &runTemplate<TableCRC16<name##_POLYNOME, name##_REV_IN>, P(16, name)> },
+#define CRC_VERIFY_32(name) CRC_VERIFY_COMMON(32, name) CRC_VERIFY_CLMUL(32, name) CRC_VERIFY_SLICING(32, name)
+#define CRC_VERIFY_64(name) CRC_VERIFY_COMMON(64, name) CRC_VERIFY_NIBBLE(64, name) CRC_VERIFY_CLMUL(64, name) \
+  CRC_VERIFY_SLICING(64, name)
+
+//  one engine list per preset
+#define PRESET(width, name, check) \
+  const Engine name##_engines[] = { CRC_VERIFY_##width(name) };
+CRC_REGISTRY_PRESETS
+#undef PRESET
+
+//  the fixed preset classes
+const Engine CRC32_fixed[] = { { "FastCRC32", &runFixed<FastCRC32> } };
+const Engine CRC32_CASTAGNOLI_fixed[] = { { "CRC32C", &runFixed<CRC32C> } };
+
+#define PRESET(width, name, check) \
+  { #name, width, check, &runClass<CRC##width, P(width, name)>, \
+    name##_engines, sizeof(name##_engines) / sizeof(name##_engines[0]) },
+const Preset presets[] =
+{
+  CRC_REGISTRY_PRESETS
+  { "CRC32", 32, 0xCBF43926, &runClass<CRC32, P(32, CRC32)>, CRC32_fixed, 1 },
+  { "CRC32_CASTAGNOLI", 32, 0xE3069283, &runClass<CRC32, P(32, CRC32_CASTAGNOLI)>, CRC32_CASTAGNOLI_fixed, 1 },
+};
+#undef PRESET
+
+const size_t presetCount = sizeof(presets) / sizeof(presets[0]);
+
+
+std::mutex outputMutex;
+std::atomic<uint64_t> failures(0);
+
+void report(const Preset &preset, const char *engine, uint64_t expected, uint64_t got,
+            const char *what)
+{
+  std::lock_guard<std::mutex> lock(outputMutex);
+  failures++;
+  printf("FAIL %-18s %-22s %s: expected %0*llX, got %0*llX\n", preset.name, engine, what,
+         (preset.width + 3) / 4, (unsigned long long)expected,
+         (preset.width + 3) / 4, (unsigned long long)got);
+}
+
+//  check values, also for the reference itself
+void verifyCheckValues()
+{
+  static const uint8_t check[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+  size_t splits[] = { 4 };
+  Message message = { check, sizeof(check), splits, 1 };
+  for (const Preset &preset : presets)
+  {
+    uint64_t reference = preset.reference(message);
+    if (reference != preset.check) report(preset, "reference", preset.check, reference, "check value");
+    for (size_t e = 0; e < preset.engineCount; e++)
+    {
+      uint64_t got = preset.engines[e].run(message);
+      if (got != preset.check) report(preset, preset.engines[e].engine, preset.check, got, "check value");
+    }
+  }
+}
+
+//  every reverse8bits() buffer kernel the CPU has against the scalar
+//  reverse8bits(uint8_t), for each length from 0 to 200 and alignment,
+//  into a second buffer and in place
+void verifyReverse8bits()
+{
+  static const char *const kernels[] = { "scalar", "SSSE3", "AVX2", "GFNI" };
+  uint8_t in[256];
+  uint8_t out[256];
+  uint8_t expected[256];
+  for (size_t i = 0; i < sizeof(in); i++) in[i] = (uint8_t)(i * 167 + 13);
+  for (size_t i = 0; i < sizeof(in); i++) expected[i] = reverse8bits(in[i]);
+
+  printf("reverse8bits kernels:");
+  for (uint8_t kernel = 0; kernel < 4; kernel++)
+  {
+    if (!crc_detail::reverse8bitsUsing(kernel, out, in, 0)) continue;
+    printf(" %s", kernels[kernel]);
+    for (size_t length = 0; length <= 200; length++)
+    {
+      const size_t offset = length % 7;
+      for (int inPlace = 0; inPlace < 2; inPlace++)
+      {
+        std::fill(out, out + sizeof(out), 0xA5);
+        if (inPlace) std::copy(in + offset, in + offset + length, out + offset);
+        crc_detail::reverse8bitsUsing(kernel, out + offset, inPlace ? out + offset : in + offset, length);
+        bool ok = std::equal(expected + offset, expected + offset + length, out + offset);
+        //  the bytes around the buffer stay untouched
+        ok = ok && out[offset + length] == 0xA5 && (offset == 0 || out[offset - 1] == 0xA5);
+        if (!ok)
+        {
+          failures++;
+          printf("\nFAIL reverse8bits %s length %zu offset %zu%s", kernels[kernel], length, offset,
+                 inPlace ? " in place" : "");
+        }
+      }
+    }
+  }
+  printf("\n");
+}
+
+struct Options
+{
+  unsigned threads;
+  uint64_t bytes;
+  size_t maxLength;
+  uint64_t seed;
+};
+
+//  mostly short messages, where the engines switch between code paths,
+//  now and then long ones
+size_t drawLength(std::mt19937_64 &random, size_t maxLength)
+{
+  static const size_t bounds[] = { 17, 300, 4096, SIZE_MAX };
+  const size_t bound = std::min(bounds[random() % 4], maxLength + 1);
+  return random() % bound;
+}
+
+void worker(unsigned index, const Options &options, std::atomic<uint64_t> &checked)
+{
+  std::mt19937_64 random(options.seed * 1000003 + index);
+  std::vector<uint8_t> buffer(options.maxLength + 64);
+  std::vector<size_t> splits;
+  uint64_t round = 0;
+
+  while (checked.load() < options.bytes && failures.load() < 20)
+  {
+    const Preset &preset = presets[(index + round++) % presetCount];
+    const size_t offset = random() % 64;
+    const size_t length = drawLength(random, options.maxLength);
+    for (size_t i = 0; i < length; i += 8)
+    {
+      uint64_t word = random();
+      for (size_t b = 0; b < 8 && i + b < length; b++) buffer[offset + i + b] = (uint8_t)(word >> (8 * b));
+    }
+
+    Message message = { buffer.data() + offset, length, nullptr, 0 };
+    const uint64_t expected = preset.reference(message);
+
+    for (size_t e = 0; e < preset.engineCount; e++)
+    {
+      splits.clear();
+      size_t pieces = length == 0 ? 0 : random() % 5;
+      for (size_t i = 0; i < pieces; i++) splits.push_back(random() % (length + 1));
+      std::sort(splits.begin(), splits.end());
+      message.splits = splits.data();
+      message.splitCount = splits.size();
+
+      uint64_t got = preset.engines[e].run(message);
+      if (got != expected)
+      {
+        char what[160];
+        snprintf(what, sizeof(what), "seed %llu thread %u length %zu offset %zu pieces %zu",
+                 (unsigned long long)options.seed, index, length, offset, splits.size() + 1);
+        report(preset, preset.engines[e].engine, expected, got, what);
+      }
+    }
+    checked += length;
+  }
+}
+}  // namespace
+
+
+int main(int argc, char *argv[])
+{
+  Options options;
+  options.threads = std::max(1u, std::thread::hardware_concurrency());
+  options.bytes = 256ull << 20;
+  options.maxLength = 1 << 20;
+  options.seed = 1;
+
+  int option;
+  while ((option = getopt(argc, argv, "j:b:l:s:h")) != -1)
+  {
+    switch (option)
+    {
+      case 'j':
+        options.threads = (unsigned)std::max(1, atoi(optarg));
+        break;
+      case 'b':
+        options.bytes = strtoull(optarg, nullptr, 10) << 20;
+        break;
+      case 'l':
+        options.maxLength = (size_t)std::max(1, atoi(optarg));
+        break;
+      case 's':
+        options.seed = strtoull(optarg, nullptr, 10);
+        break;
+      default:
+        fprintf(stderr,
+                "usage: crc_verify [-j threads] [-b megabytes] [-l maxLength] [-s seed]\n"
+                "  -j  worker threads, default all cores\n"
+                "  -b  reference data to check in MB, default 256\n"
+                "  -l  longest random message, default 1048576\n"
+                "  -s  seed of the random messages, default 1\n");
+        return 2;
+    }
+  }
+
+  size_t engineCount = 0;
+  for (const Preset &preset : presets) engineCount += preset.engineCount;
+  printf("%zu presets, %zu engine instances, %u threads, CLMUL %s, CRC32C %s\n",
+         presetCount, engineCount, options.threads,
+#if defined(CRC_CLMUL_X86)
+         crc_detail::clmulSupported() ? "hardware" : "portable",
+#else
+         "portable",
+#endif
+         CRC32C::hardware() ? "hardware" : "portable");
+
+  verifyCheckValues();
+  verifyReverse8bits();
+
+  std::atomic<uint64_t> checked(0);
+  std::vector<std::thread> pool;
+  for (unsigned t = 0; t < options.threads; t++)
+  {
+    pool.emplace_back(worker, t, std::cref(options), std::ref(checked));
+  }
+  for (std::thread &thread : pool) thread.join();
+
+  printf("%llu MB of reference data checked, %llu failures\n",
+         (unsigned long long)(checked.load() >> 20), (unsigned long long)failures.load());
+  return failures.load() == 0 ? 0 : 1;
+}
+
+
+//  -- END OF FILE --
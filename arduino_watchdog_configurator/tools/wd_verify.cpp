@@ -0,0 +1,458 @@
+//
+//    FILE: wd_verify.cpp
+// PURPOSE: differential verification of the watchdog frame decoders
+//
+//  usage: wd_verify [-n streams] [-s seed]
+//
+//  Random streams of input frames, 'W' 'C', sequenced 'W' 'S' and
+//  batches 'W' 'B', with garbage between them, some frames corrupted,
+//  cut short or with malformed commands, must decode the same:
+//  - byte by byte with WdInputByteProcessor::processByte(), the
+//    reference;
+//  - with the handler overload of processBytes() and with
+//    processFrames(), both over random chunks;
+//  - with the array overload of processBytes(), random chunks and a
+//    random maxFrames, for the single and sequenced frames.
+//  WdInFlight is checked against a plain model over sequence number
+//  wrap around, answers in any order, stale answers and expiry across
+//  the millis() wrap; WdRequestQueue against a std::deque.
+//  A mismatch prints the check, seed and stream, and the exit status
+//  is 1.
+//
+//  build and run with: make verify
+
+
+#include "../include/WdFrameView.hpp"
+#include "../include/WdInFlight.hpp"
+#include "../include/WdInput.hpp"
+#include "../include/WdInputByteProcessor.hpp"
+#include "../include/WdRequestQueue.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+
+namespace
+{
+typedef WdInputByteProcessor::WdInputMessageProcessState State;
+
+//  the time of every byte, no timeouts
+const ulong NOW_MS = 5;
+
+struct Options
+{
+  unsigned streams;
+  uint64_t seed;
+};
+
+unsigned failures = 0;
+
+
+void fail(const char *check, const Options &options, unsigned stream, const std::string &detail)
+{
+  failures++;
+  printf("MISMATCH %s  seed %llu  stream %u  %s\n", check,
+         (unsigned long long)options.seed, stream, detail.c_str());
+}
+
+std::string describeBatch(const WdInputBatchView &batch)
+{
+  std::string text = batch.valid() ? "B" : "B!";
+  char item[32];
+  batch.forEachCommand([&](size_t index, uint8_t cmd, const uint8_t *value, uint8_t length)
+  {
+    snprintf(item, sizeof(item), " %zu:%02X/%u", index, cmd, length);
+    text += item;
+    for (uint8_t i = 0; i < length; i++)
+    {
+      snprintf(item, sizeof(item), ".%02X", value[i]);
+      text += item;
+    }
+  });
+  return text + ";";
+}
+
+//  one reported frame as text, the streams of frames are compared
+std::string describe(State state, const WdInputMsg &msg, const WdInputByteProcessor &processor)
+{
+  char text[32];
+  switch (state)
+  {
+    case State::InputMessageComplete:
+      snprintf(text, sizeof(text), "C%02X%s;", msg.getCmd(), msg.isSequenced() ? "s" : "");
+      return text;
+    case State::InputSequencedComplete:
+      snprintf(text, sizeof(text), "S%02X/%02X%s;", msg.getSequence(), msg.getCmd(),
+               msg.isSequenced() ? "" : "!");
+      return text;
+    case State::InputBatchComplete:
+      return describeBatch(processor.getBatch());
+    case State::InputMessageInvalidCrc:
+      return "X;";
+    default:
+      return "?;";
+  }
+}
+
+//  the frame handed to a processFrames() handler, read through its view
+std::string describeFrame(State state, const uint8_t *frame, const WdInputByteProcessor &processor)
+{
+  WdInputMsg msg;
+  if (state == State::InputMessageComplete)
+  {
+    WdInputMsgView view(frame, WdInputMsgView::size());
+    if (!view.valid()) return "C!;";
+    msg.setCmd(view.getCmd());
+  }
+  else if (state == State::InputSequencedComplete)
+  {
+    WdSequencedInputMsgView view(frame, WdSequencedInputMsgView::size());
+    if (!view.valid()) return "S!;";
+    msg.setCmd(view.getCmd());
+    msg.setSequence(view.getSequence());
+  }
+  return describe(state, msg, processor);
+}
+
+//  the part of a and b around their first difference
+std::string difference(const std::string &a, const std::string &b)
+{
+  size_t at = 0;
+  while (at < a.size() && at < b.size() && a[at] == b[at]) at++;
+  const size_t from = at > 40 ? at - 40 : 0;
+  return "at " + std::to_string(at) + ": " + a.substr(from, 100) + " | " + b.substr(from, 100);
+}
+
+
+//  A stream of frames of every kind. Garbage is biased to start bytes,
+//  one frame in 12 has a bit flipped, one in 40 is cut short.
+std::vector<uint8_t> makeStream(std::mt19937_64 &random)
+{
+  std::vector<uint8_t> stream;
+  const uint8_t startBytes[] = { 'W', 'C', 'S', 'B' };
+  for (unsigned frame = 0; frame < 2000; frame++)
+  {
+    for (unsigned garbage = random() % 6; garbage > 0; garbage--)
+    {
+      stream.push_back(random() % 2 ? startBytes[random() % 4] : (uint8_t)random());
+    }
+
+    uint8_t bytes[WdInputMsg::BatchFrame::kMaxFrameSize];
+    size_t length = 0;
+    switch (random() % 4)
+    {
+      case 0:
+      {
+        WdInputMsg msg;
+        msg.setCmd((uint8_t)random());
+        length = msg.encode(bytes);
+        break;
+      }
+      case 1:
+      {
+        WdInputMsg msg;
+        msg.setCmd((uint8_t)random());
+        msg.setSequence((uint8_t)random());
+        length = msg.encode(bytes);
+        break;
+      }
+      case 2:
+      {
+        WdInputBatch batch;
+        for (unsigned commands = random() % 7; commands > 0; commands--)
+        {
+          const uint8_t value[4] = { (uint8_t)random(), 'W', 'B', (uint8_t)random() };
+          batch.add((uint8_t)random(), value, (uint8_t)(random() % 5));
+        }
+        length = batch.encode(bytes);
+        break;
+      }
+      default:
+      {
+        //  intact CRC, the commands need not fill the payload
+        uint8_t payload[WdInputMsg::kMaxBatchPayloadSize];
+        const size_t size = random() % (sizeof(payload) + 1);
+        for (size_t i = 0; i < size; i++) payload[i] = (uint8_t)random();
+        length = WdInputMsg::BatchFrame::encode(bytes, payload, size);
+      }
+    }
+    if (random() % 12 == 0) bytes[random() % length] ^= (uint8_t)(1 << (random() % 8));
+    if (random() % 40 == 0) length = random() % length;
+    stream.insert(stream.end(), bytes, bytes + length);
+  }
+  return stream;
+}
+
+//  chunk sizes from 1 to 64 bytes covering the stream
+std::vector<size_t> makeChunks(std::mt19937_64 &random, size_t size)
+{
+  std::vector<size_t> chunks;
+  for (size_t used = 0; used < size;)
+  {
+    const size_t chunk = std::min<size_t>(1 + random() % 64, size - used);
+    chunks.push_back(chunk);
+    used += chunk;
+  }
+  return chunks;
+}
+
+void verifyStream(const Options &options, unsigned stream, uint64_t &frames)
+{
+  std::mt19937_64 random(options.seed * 1000003 + stream);
+  const std::vector<uint8_t> bytes = makeStream(random);
+  const std::vector<size_t> chunks = makeChunks(random, bytes.size());
+
+  //  reference, and its single and sequenced frames for the array overload
+  WdInputMsg referenceMsg;
+  WdInputByteProcessor reference(referenceMsg);
+  std::string expected;
+  std::string expectedMessages;
+  for (uint8_t byte : bytes)
+  {
+    const State state = reference.processByte(byte, NOW_MS);
+    if (state == State::InputMessageIncomplete) continue;
+    const std::string text = describe(state, referenceMsg, reference);
+    expected += text;
+    if (state == State::InputMessageComplete || state == State::InputSequencedComplete)
+    {
+      expectedMessages += text;
+    }
+    frames++;
+  }
+
+  WdInputMsg bulkMsg;
+  WdInputByteProcessor bulk(bulkMsg);
+  std::string bulkFrames;
+  WdInputMsg viewMsg;
+  WdInputByteProcessor views(viewMsg);
+  std::string viewFrames;
+  size_t at = 0;
+  for (size_t chunk : chunks)
+  {
+    bulk.processBytes(&bytes[at], chunk, NOW_MS, [&](State state, const WdInputMsg &msg)
+    {
+      bulkFrames += describe(state, msg, bulk);
+    });
+    views.processFrames(&bytes[at], chunk, NOW_MS, [&](State state, const uint8_t *frame)
+    {
+      viewFrames += describeFrame(state, frame, views);
+    });
+    at += chunk;
+  }
+  if (bulkFrames != expected) fail("processBytes", options, stream, difference(expected, bulkFrames));
+  if (viewFrames != expected) fail("processFrames", options, stream, difference(expected, viewFrames));
+
+  WdInputMsg arrayMsg;
+  WdInputByteProcessor array(arrayMsg);
+  std::string arrayFrames;
+  WdInputMsg stored[4];
+  at = 0;
+  for (size_t chunk : chunks)
+  {
+    const size_t end = at + chunk;
+    while (at < end)
+    {
+      size_t consumed = 0;
+      const size_t maxFrames = 1 + random() % 4;
+      const size_t count = array.processBytes(&bytes[at], end - at, NOW_MS, stored, maxFrames, consumed);
+      for (size_t i = 0; i < count; i++)
+      {
+        const State state = stored[i].isSequenced() ? State::InputSequencedComplete
+                                                    : State::InputMessageComplete;
+        arrayFrames += describe(state, stored[i], array);
+      }
+      if (count > maxFrames || (count < maxFrames && consumed != end - at))
+      {
+        fail("processBytes array", options, stream, "stopped early at " + std::to_string(at));
+        return;
+      }
+      at += consumed;
+    }
+  }
+  if (arrayFrames != expectedMessages)
+  {
+    fail("processBytes array", options, stream, difference(expectedMessages, arrayFrames));
+  }
+}
+
+
+//  WdInFlight<8> against a map of the sequence numbers in flight
+void verifyInFlight(const Options &options, unsigned stream)
+{
+  const size_t capacity = 8;
+  const ulong timeoutMs = 50;
+  std::mt19937_64 random(options.seed * 1000003 + stream);
+  WdInFlight<capacity> inFlight;
+
+  struct Sent
+  {
+    uint8_t cmd;
+    ulong timeMs;
+  };
+  std::map<uint8_t, Sent> model;
+  uint8_t nextSequence = 0;
+  //  starts just before the ulong wrap, as millis() does
+  ulong now = (ulong)0 - 256;
+  char detail[96];
+
+  for (unsigned step = 0; step < 20000; step++)
+  {
+    now += random() % 4;
+    bool slotBusy = false;
+    for (const auto &sent : model) slotBusy |= (sent.first ^ nextSequence) % capacity == 0;
+
+    switch (random() % 3)
+    {
+      case 0:
+      {
+        const uint8_t cmd = (uint8_t)random();
+        uint8_t sequence = 0;
+        const bool begun = inFlight.begin(cmd, now, sequence);
+        if (begun == slotBusy || (begun && sequence != nextSequence))
+        {
+          snprintf(detail, sizeof(detail), "begin step %u next %u", step, nextSequence);
+          fail("WdInFlight", options, stream, detail);
+          return;
+        }
+        if (begun) model[nextSequence++] = Sent{ cmd, now };
+        break;
+      }
+      case 1:
+      {
+        //  mostly recent numbers, some stale or never sent
+        const uint8_t sequence = (uint8_t)(nextSequence - 1 - random() % (2 * capacity));
+        uint8_t cmd = 0;
+        const auto sent = model.find(sequence);
+        const bool matched = inFlight.complete(sequence, cmd);
+        if (matched != (sent != model.end()) || (matched && cmd != sent->second.cmd))
+        {
+          snprintf(detail, sizeof(detail), "complete step %u sequence %u", step, sequence);
+          fail("WdInFlight", options, stream, detail);
+          return;
+        }
+        if (matched) model.erase(sent);
+        break;
+      }
+      default:
+      {
+        std::map<uint8_t, Sent> expired;
+        for (const auto &sent : model)
+        {
+          if (now - sent.second.timeMs > timeoutMs) expired.insert(sent);
+        }
+        bool same = true;
+        const size_t count = inFlight.expire(now, timeoutMs, [&](uint8_t sequence, uint8_t cmd)
+        {
+          const auto sent = expired.find(sequence);
+          same &= sent != expired.end() && sent->second.cmd == cmd;
+        });
+        if (!same || count != expired.size())
+        {
+          snprintf(detail, sizeof(detail), "expire step %u now %lu", step, now);
+          fail("WdInFlight", options, stream, detail);
+          return;
+        }
+        for (const auto &sent : expired) model.erase(sent.first);
+      }
+    }
+    if (inFlight.size() != model.size() || inFlight.empty() != model.empty())
+    {
+      snprintf(detail, sizeof(detail), "size step %u", step);
+      fail("WdInFlight", options, stream, detail);
+      return;
+    }
+  }
+}
+
+//  WdRequestQueue<5> against a std::deque
+void verifyRequestQueue(const Options &options, unsigned stream)
+{
+  const size_t capacity = 5;
+  std::mt19937_64 random(options.seed * 1000003 + stream);
+  WdRequestQueue<capacity> queue;
+  std::deque<WdRequest> model;
+
+  for (unsigned step = 0; step < 20000; step++)
+  {
+    bool same = true;
+    if (random() % 2)
+    {
+      WdInputMsg msg;
+      msg.setCmd((uint8_t)random());
+      if (random() % 2) msg.setSequence((uint8_t)random());
+      const bool pushed = queue.push(msg);
+      same = pushed == (model.size() < capacity);
+      if (pushed) model.push_back(WdRequest{ msg.getCmd(), msg.getSequence(), msg.isSequenced() });
+    }
+    else
+    {
+      WdRequest request = {};
+      const bool popped = queue.pop(request);
+      same = popped == !model.empty();
+      if (popped)
+      {
+        const WdRequest &oldest = model.front();
+        same = request.mCmd == oldest.mCmd && request.mSequenced == oldest.mSequenced &&
+               (!request.mSequenced || request.mSequence == oldest.mSequence);
+        model.pop_front();
+      }
+    }
+    if (!same || queue.size() != model.size())
+    {
+      fail("WdRequestQueue", options, stream, "step " + std::to_string(step));
+      return;
+    }
+  }
+}
+}  // namespace
+
+
+int main(int argc, char *argv[])
+{
+  Options options;
+  options.streams = 100;
+  options.seed = 1;
+
+  int option;
+  while ((option = getopt(argc, argv, "n:s:h")) != -1)
+  {
+    switch (option)
+    {
+      case 'n':
+        options.streams = (unsigned)std::max(1, atoi(optarg));
+        break;
+      case 's':
+        options.seed = strtoull(optarg, nullptr, 10);
+        break;
+      default:
+        fprintf(stderr,
+                "usage: wd_verify [-n streams] [-s seed]\n"
+                "  -n  random frame streams to decode, default 100\n"
+                "  -s  seed of the random streams, default 1\n");
+        return 2;
+    }
+  }
+
+  uint64_t frames = 0;
+  for (unsigned stream = 0; stream < options.streams; stream++)
+  {
+    verifyStream(options, stream, frames);
+    verifyInFlight(options, stream);
+    verifyRequestQueue(options, stream);
+  }
+
+  printf("%u streams, %llu frames decoded 4 ways, %u failures\n",
+         options.streams, (unsigned long long)frames, failures);
+  return failures == 0 ? 0 : 1;
+}
+
+
+//  -- END OF FILE --
@@ -0,0 +1,293 @@
+//
+//    FILE: wdcrc.cpp
+// PURPOSE: host checksummer for the presets in CrcParameters.h
+//
+//  usage: wdcrc [-p preset] [-j threads] [-c chunkKB] [-v] [-l] [file ...]
+//
+//  Regular files are memory mapped and cut into chunks, a pool of worker
+//  threads checksums the chunks independently and the chunk CRCs are
+//  merged in file order with CrcRuntime::combine() (CrcCombine.h).
+//  Pipes, stdin ("-" or no file) and files that cannot be mapped are
+//  read in chunk sized blocks which are merged the same way.
+//  Presets are looked up in CrcRegistry.h; the chunks run through the
+//  fastest engine of the preset's width, see computes[].
+//  -v reports size, time and throughput per file on stderr.
+//
+//  build with: make wdcrc
+
+
+#include "CRC.h"
+#include "CRC32C.h"
+#include "CrcRegistry.h"
+#include "ClmulCRC16.h"
+#include "ClmulCRC32.h"
+#include "ClmulCRC64.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace
+{
+typedef uint64_t (*ComputeFunction)(const uint8_t *array, size_t length);
+
+//  CRC8 and CRC12 presets use the byte table
+template <typename Parameters>
+uint64_t tableCompute(const uint8_t *array, size_t length)
+{
+  return Parameters::compute(array, length);
+}
+
+//  CRC16, CRC32 and CRC64 presets use PCLMULQDQ folding when available
+template <typename Engine, typename Parameters>
+uint64_t clmulCompute(const uint8_t *array, size_t length)
+{
+  Engine crc(Parameters::getInitial(), Parameters::getXorOut(), Parameters::getReverseOut());
+  crc.add(array, length);
+  return crc.calc();
+}
+
+//  CRC32_CASTAGNOLI uses the SSE4.2 crc32 instruction when available
+template <>
+uint64_t clmulCompute<ClmulCRC32<CRC32_CASTAGNOLI_POLYNOME, CRC32_CASTAGNOLI_REV_IN>,
+                      CRC_PRESET(32, CRC32_CASTAGNOLI)>(const uint8_t *array, size_t length)
+{
+  CRC32C crc;
+  crc.add(array, length);
+  return crc.calc();
+}
+
+#define WDCRC_TABLE(width, name) &tableCompute<CRC_PRESET(width, name)>,
+#define WDCRC_CLMUL(width, name) \
+  &clmulCompute<ClmulCRC##width<name##_POLYNOME, name##_REV_IN>, CRC_PRESET(width, name)>,
+#define WDCRC_8(name) WDCRC_TABLE(8, name)
+#define WDCRC_12(name) WDCRC_TABLE(12, name)
+#define WDCRC_16(name) WDCRC_CLMUL(16, name)
+#define WDCRC_32(name) WDCRC_CLMUL(32, name)
+#define WDCRC_64(name) WDCRC_CLMUL(64, name)
+#define PRESET(width, name, check) WDCRC_##width(name)
+
+//  the compute function of crcPresetAt(i), from the same preset list
+const ComputeFunction computes[] =
+{
+  CRC_REGISTRY_PRESETS
+};
+
+#undef PRESET
+#undef WDCRC_TABLE
+#undef WDCRC_CLMUL
+#undef WDCRC_8
+#undef WDCRC_12
+#undef WDCRC_16
+#undef WDCRC_32
+#undef WDCRC_64
+
+
+struct Options
+{
+  const CrcPreset *preset;
+  ComputeFunction compute;
+  unsigned threads;
+  size_t chunkSize;
+  bool verbose;
+};
+
+//  false for an unknown preset name
+bool selectPreset(const char *name, Options &options)
+{
+  options.preset = crcFindPreset(name);
+  if (options.preset == nullptr) return false;
+  for (size_t i = 0; i < crcPresetCount(); i++)
+  {
+    if (&crcPresetAt(i) == options.preset) options.compute = computes[i];
+  }
+  return true;
+}
+
+//  Checksums size bytes at data, chunks are handed out to the workers
+//  through a shared counter and merged in order afterwards.
+uint64_t checksumMapped(const uint8_t *data, size_t size, const Options &options)
+{
+  const CrcPreset &preset = *options.preset;
+  const size_t chunks = (size + options.chunkSize - 1) / options.chunkSize;
+  if (chunks <= 1) return options.compute(data, size);
+
+  std::vector<uint64_t> results(chunks);
+  std::atomic<size_t> next(0);
+  auto worker = [&]()
+  {
+    for (size_t chunk = next++; chunk < chunks; chunk = next++)
+    {
+      const size_t offset = chunk * options.chunkSize;
+      results[chunk] = options.compute(data + offset, std::min(options.chunkSize, size - offset));
+    }
+  };
+
+  const unsigned threads = (unsigned)std::min<size_t>(options.threads, chunks);
+  std::vector<std::thread> pool;
+  for (unsigned t = 1; t < threads; t++) pool.emplace_back(worker);
+  worker();
+  for (std::thread &thread : pool) thread.join();
+
+  uint64_t crc = results[0];
+  for (size_t chunk = 1; chunk < chunks; chunk++)
+  {
+    const size_t offset = chunk * options.chunkSize;
+    crc = CrcRuntime::combine(preset, crc, results[chunk], std::min(options.chunkSize, size - offset));
+  }
+  return crc;
+}
+
+//  Streaming fallback, the CRC of the empty message combined with the
+//  first block is the CRC of that block.
+bool checksumStream(int fd, const Options &options, uint64_t &crc, uint64_t &size)
+{
+  const CrcPreset &preset = *options.preset;
+  std::vector<uint8_t> block(options.chunkSize);
+  crc = options.compute(block.data(), 0);
+  size = 0;
+  while (true)
+  {
+    size_t filled = 0;
+    while (filled < block.size())
+    {
+      ssize_t got = read(fd, block.data() + filled, block.size() - filled);
+      if (got < 0) return false;
+      if (got == 0) break;
+      filled += (size_t)got;
+    }
+    if (filled == 0) return true;
+    crc = CrcRuntime::combine(preset, crc, options.compute(block.data(), filled), filled);
+    size += filled;
+    if (filled < block.size()) return true;
+  }
+}
+
+bool checksumFile(const char *path, const Options &options, uint64_t &crc, uint64_t &size)
+{
+  const bool useStdin = path[0] == '-' && path[1] == 0;
+  const int fd = useStdin ? STDIN_FILENO : open(path, O_RDONLY);
+  if (fd < 0) return false;
+
+  bool ok = false;
+  struct stat info;
+  void *mapping = MAP_FAILED;
+  if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0)
+  {
+    mapping = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+  if (mapping != MAP_FAILED)
+  {
+    madvise(mapping, (size_t)info.st_size, MADV_WILLNEED);
+    size = (uint64_t)info.st_size;
+    crc = checksumMapped((const uint8_t *)mapping, (size_t)info.st_size, options);
+    munmap(mapping, (size_t)info.st_size);
+    ok = true;
+  }
+  else
+  {
+    ok = checksumStream(fd, options, crc, size);
+  }
+
+  if (!useStdin) close(fd);
+  return ok;
+}
+
+void usage()
+{
+  fprintf(stderr,
+          "usage: wdcrc [-p preset] [-j threads] [-c chunkKB] [-v] [-l] [file ...]\n"
+          "  -p  preset from CrcParameters.h, default CRC32\n"
+          "  -j  worker threads, default all cores\n"
+          "  -c  chunk size in KB, default 1024\n"
+          "  -v  report size, time and throughput on stderr\n"
+          "  -l  list the presets with their check values\n"
+          "  without file, or with -, stdin is read\n");
+}
+}  // namespace
+
+
+int main(int argc, char *argv[])
+{
+  Options options;
+  selectPreset("CRC32", options);
+  options.threads = std::max(1u, std::thread::hardware_concurrency());
+  options.chunkSize = 1024 * 1024;
+  options.verbose = false;
+
+  int option;
+  while ((option = getopt(argc, argv, "p:j:c:vlh")) != -1)
+  {
+    switch (option)
+    {
+      case 'p':
+        if (!selectPreset(optarg, options))
+        {
+          fprintf(stderr, "wdcrc: unknown preset %s, -l lists them\n", optarg);
+          return 2;
+        }
+        break;
+      case 'j':
+        options.threads = (unsigned)std::max(1, atoi(optarg));
+        break;
+      case 'c':
+        options.chunkSize = (size_t)std::max(1, atoi(optarg)) * 1024;
+        break;
+      case 'v':
+        options.verbose = true;
+        break;
+      case 'l':
+        for (size_t i = 0; i < crcPresetCount(); i++)
+        {
+          const CrcPreset &preset = crcPresetAt(i);
+          printf("%-20s %2u bit  check %0*llX\n", preset.name, preset.width,
+                 (preset.width + 3) / 4, (unsigned long long)preset.check);
+        }
+        return 0;
+      default:
+        usage();
+        return 2;
+    }
+  }
+
+  static const char *stdinOnly[] = { "-" };
+  const char *const *files = optind < argc ? argv + optind : stdinOnly;
+  const int fileCount = optind < argc ? argc - optind : 1;
+
+  int status = 0;
+  for (int i = 0; i < fileCount; i++)
+  {
+    uint64_t crc = 0;
+    uint64_t size = 0;
+    auto start = std::chrono::steady_clock::now();
+    if (!checksumFile(files[i], options, crc, size))
+    {
+      perror(files[i]);
+      status = 1;
+      continue;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("%0*llx  %s\n", (options.preset->width + 3) / 4, (unsigned long long)crc, files[i]);
+    if (options.verbose)
+    {
+      fprintf(stderr, "%s: %s, %llu bytes, %.3f s, %.1f MB/s, %u threads\n",
+              files[i], options.preset->name, (unsigned long long)size, seconds,
+              seconds > 0 ? size / seconds / 1e6 : 0.0, options.threads);
+    }
+  }
+  return status;
+}
+
+
+//  -- END OF FILE --
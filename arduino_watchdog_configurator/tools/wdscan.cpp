@@ -0,0 +1,257 @@
+//
+//    FILE: wdscan.cpp
+// PURPOSE: find watchdog frames in serial captures
+//
+//  usage: wdscan [-s statusSize] [-r] [-v] [file ...]
+//
+//  Candidate frame starts are located with wdFindSyncPattern()
+//  (include/WdSyncScanner.hpp), so the garbage between frames is skipped
+//  at memory speed: one scan finds input frames, 'W' followed by 'C',
+//  'S' (sequenced) or 'B' (batch), the other responses, 'W' followed by
+//  'R' or 'A' (sequenced). Each candidate is checked with the WdCrc16
+//  residue; a response carries statusSize status bytes
+//  (WdResponse<StatusSize>), a batch is as long as its length byte says.
+//  A 'W' 'R' response failing the check at statusSize is checked again
+//  as the reply to a batch, with kMaxBatchCommands status bytes
+//  (WdManager::sendBatchResponse()). Candidates failing the check,
+//  damaged frames, frames cut off by the end of the capture or start
+//  bytes in garbage, count as bad; the scan goes on after their first
+//  byte.
+//  -r takes captures whose bytes arrive bit reversed, e.g. from a logic
+//  analyzer decoding the UART MSB first; they are reversed with the
+//  reverse8bits() buffer kernel (crc/CrcFastReverse.h) before the scan.
+//  -v prints every frame found, sequenced ones with their sequence
+//  number.
+//
+//  build with: make wdscan
+
+
+#include "../include/WdCrc.hpp"
+#include "../include/WdFrameSchema.hpp"
+#include "../include/WdInput.hpp"
+#include "../include/WdSyncScanner.hpp"
+#include "CrcFastReverse.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace
+{
+//  the responses without their status bytes, WdResponse.hpp needs Arduino
+typedef WdFrameSchema<WdInputMsg::kInputMsgStartByte1, 'R', WdCrc16, 1> ResponseFrame;
+typedef WdFrameSchema<WdInputMsg::kInputMsgStartByte1, 'A', WdCrc16, 1, 1> SequencedResponseFrame;
+typedef WdInputMsg::BatchFrame BatchFrame;
+const size_t INPUT_FRAME_SIZE = WdInputMsg::Frame::kFrameSize;
+const size_t SEQUENCED_FRAME_SIZE = WdInputMsg::SequencedFrame::kFrameSize;
+//  WdManager::sendBatchResponse(), one status byte per batch command
+const size_t BATCH_RESPONSE_SIZE = ResponseFrame::kFrameSize + WdInputMsg::kMaxBatchCommands;
+
+struct Options
+{
+  size_t statusSize;
+  bool reverseBits;
+  bool verbose;
+};
+
+struct Counts
+{
+  uint64_t inputOk;
+  uint64_t inputBad;
+  uint64_t responseOk;
+  uint64_t responseBad;
+  //  intact frames of the newer kinds, included in the counts above
+  uint64_t sequencedInputs;
+  uint64_t batches;
+  uint64_t sequencedResponses;
+  uint64_t batchResponses;
+};
+
+const uint8_t *findInput(const uint8_t *at, const uint8_t *end)
+{
+  return wdFindSyncPattern(at, end, WdInputMsg::kInputMsgStartByte1, WdInputMsg::kInputMsgStartByte2,
+                           WdInputMsg::kSequencedMsgStartByte2, WdInputMsg::kBatchMsgStartByte2);
+}
+
+const uint8_t *findResponse(const uint8_t *at, const uint8_t *end)
+{
+  return wdFindSyncPattern(at, end, WdInputMsg::kInputMsgStartByte1, ResponseFrame::kStartByte2,
+                           SequencedResponseFrame::kStartByte2);
+}
+
+void scan(const uint8_t *data, size_t size, const char *path, const Options &options, Counts &counts)
+{
+  const uint8_t *const end = data + size;
+  const size_t responseSize = ResponseFrame::kFrameSize + options.statusSize;
+  //  the next candidate of each scan, the nearer one is checked first
+  const uint8_t *input = findInput(data, end);
+  const uint8_t *response = findResponse(data, end);
+  const uint8_t *at = data;
+  while (true)
+  {
+    if (input < at) input = findInput(at, end);
+    if (response < at) response = findResponse(at, end);
+    at = std::min(input, response);
+    if (at == end) break;
+
+    const bool isInput = at == input;
+    const bool sequenced = at[1] == WdInputMsg::kSequencedMsgStartByte2 ||
+                           at[1] == SequencedResponseFrame::kStartByte2;
+    const bool batch = at[1] == BatchFrame::kStartByte2;
+    const size_t available = (size_t)(end - at);
+    size_t frameSize = responseSize + (sequenced ? 1 : 0);
+    if (isInput) frameSize = sequenced ? SEQUENCED_FRAME_SIZE : INPUT_FRAME_SIZE;
+    bool inRange = true;
+    if (batch)
+    {
+      //  a length out of range is bad, only the header is shown
+      inRange = available > BatchFrame::kLengthOffset &&
+                at[BatchFrame::kLengthOffset] <= BatchFrame::kMaxPayloadSize;
+      frameSize = inRange ? BatchFrame::frameSize(at[BatchFrame::kLengthOffset])
+                          : BatchFrame::kPayloadOffset;
+    }
+
+    //  a frame running past the end of the capture is bad too, a start
+    //  pattern inside it may begin an intact frame
+    bool ok = inRange && frameSize <= available && WdCrc16::verify(at, frameSize);
+    bool batchResponse = false;
+    if (!ok && !isInput && !sequenced && BATCH_RESPONSE_SIZE <= available &&
+        WdCrc16::verify(at, BATCH_RESPONSE_SIZE))
+    {
+      ok = batchResponse = true;
+      frameSize = BATCH_RESPONSE_SIZE;
+    }
+    if (isInput) (ok ? counts.inputOk : counts.inputBad)++;
+    else (ok ? counts.responseOk : counts.responseBad)++;
+    if (ok && batch) counts.batches++;
+    if (batchResponse) counts.batchResponses++;
+    if (ok && sequenced) (isInput ? counts.sequencedInputs : counts.sequencedResponses)++;
+
+    if (options.verbose)
+    {
+      printf("%s: %10zu  %s  %s ", path, (size_t)(at - data),
+             batch ? "batch   " : isInput ? "input   " : "response", ok ? "ok " : "bad");
+      //  the sequence number follows the start bytes in both directions
+      if (sequenced) printf(" seq %02X ", at[2]);
+      else printf("        ");
+      for (size_t i = 0; i < std::min(frameSize, available); i++) printf(" %02X", at[i]);
+      printf("\n");
+    }
+    //  an intact frame is skipped, a bad one may hide the next start
+    at += ok ? frameSize : 1;
+  }
+}
+
+bool scanFile(const char *path, const Options &options, Counts &counts, uint64_t &size)
+{
+  const bool useStdin = path[0] == '-' && path[1] == 0;
+  const int fd = useStdin ? STDIN_FILENO : open(path, O_RDONLY);
+  if (fd < 0) return false;
+
+  bool ok = true;
+  struct stat info;
+  void *mapping = MAP_FAILED;
+  if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0)
+  {
+    //  a private writable mapping to reverse the bits in place
+    const int protection = options.reverseBits ? PROT_READ | PROT_WRITE : PROT_READ;
+    mapping = mmap(nullptr, (size_t)info.st_size, protection, MAP_PRIVATE, fd, 0);
+  }
+  if (mapping != MAP_FAILED)
+  {
+    madvise(mapping, (size_t)info.st_size, MADV_SEQUENTIAL);
+    size = (uint64_t)info.st_size;
+    if (options.reverseBits) reverse8bits((uint8_t *)mapping, (const uint8_t *)mapping, (crc_size_t)size);
+    scan((const uint8_t *)mapping, (size_t)info.st_size, path, options, counts);
+    munmap(mapping, (size_t)info.st_size);
+  }
+  else
+  {
+    //  pipes and empty files are read completely first
+    std::vector<uint8_t> buffer;
+    uint8_t block[65536];
+    ssize_t got;
+    while ((got = read(fd, block, sizeof(block))) > 0) buffer.insert(buffer.end(), block, block + got);
+    ok = got == 0;
+    size = buffer.size();
+    if (options.reverseBits) reverse8bits(buffer.data(), buffer.data(), (crc_size_t)size);
+    scan(buffer.data(), buffer.size(), path, options, counts);
+  }
+
+  if (!useStdin) close(fd);
+  return ok;
+}
+}  // namespace
+
+
+int main(int argc, char *argv[])
+{
+  Options options;
+  options.statusSize = 1;
+  options.reverseBits = false;
+  options.verbose = false;
+
+  int option;
+  while ((option = getopt(argc, argv, "s:rvh")) != -1)
+  {
+    switch (option)
+    {
+      case 's':
+        options.statusSize = (size_t)std::max(1, atoi(optarg));
+        break;
+      case 'r':
+        options.reverseBits = true;
+        break;
+      case 'v':
+        options.verbose = true;
+        break;
+      default:
+        fprintf(stderr,
+                "usage: wdscan [-s statusSize] [-r] [-v] [file ...]\n"
+                "  -s  status bytes per response, default 1\n"
+                "  -r  the bits of every captured byte are reversed\n"
+                "  -v  print every frame found\n"
+                "  without file, or with -, stdin is read\n");
+        return 2;
+    }
+  }
+
+  static const char *stdinOnly[] = { "-" };
+  const char *const *files = optind < argc ? argv + optind : stdinOnly;
+  const int fileCount = optind < argc ? argc - optind : 1;
+
+  int status = 0;
+  for (int i = 0; i < fileCount; i++)
+  {
+    Counts counts = {};
+    uint64_t size = 0;
+    auto start = std::chrono::steady_clock::now();
+    if (!scanFile(files[i], options, counts, size))
+    {
+      perror(files[i]);
+      status = 1;
+      continue;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("%s: %llu bytes, input %llu ok %llu bad (%llu sequenced, %llu batches), "
+           "response %llu ok %llu bad (%llu sequenced, %llu to batches), %.1f MB/s\n",
+           files[i], (unsigned long long)size,
+           (unsigned long long)counts.inputOk, (unsigned long long)counts.inputBad,
+           (unsigned long long)counts.sequencedInputs, (unsigned long long)counts.batches,
+           (unsigned long long)counts.responseOk, (unsigned long long)counts.responseBad,
+           (unsigned long long)counts.sequencedResponses, (unsigned long long)counts.batchResponses,
+           seconds > 0 ? size / seconds / 1e6 : 0.0);
+  }
+  return status;
+}
+
+
+//  -- END OF FILE --